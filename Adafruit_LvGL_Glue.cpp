@@ -1,29 +1,32 @@
 #include "Adafruit_LvGL_Glue.h"
 #include <lvgl.h>
-
-lv_disp_draw_buf_t Adafruit_LvGL_Glue::lv_disp_draw_buf;
-lv_disp_drv_t Adafruit_LvGL_Glue::lv_disp_drv;
-lv_color_t *Adafruit_LvGL_Glue::lv_pixel_buf;
-lv_indev_drv_t Adafruit_LvGL_Glue::lv_indev_drv;
+#include <math.h>
 
 // ARCHITECTURE-SPECIFIC TIMER STUFF ---------------------------------------
 
 // Tick interval for LittlevGL internal timekeeping; 1 to 10 ms recommended
 static const int lv_tick_interval_ms = 10;
 
-#if defined(ARDUINO_ARCH_SAMD) // --------------------------------------
+// With LV_TICK_CUSTOM set in lv_conf.h, LittlevGL reads millis() itself
+// and the glue runs "tickless": no periodic timer interrupt, and the GUI
+// (ESP32 task, or service() elsewhere) sleeps until LittlevGL's next timer
+// is due, or until woken by new touch input or by lvgl_release().
+
+// Run one pass of LittlevGL's timers, returns ms until the next is due
+static uint32_t lvgl_timer_pass(void);
 
-// Because of the way timer/counters are paired, and because parallel TFT
-// uses timer 2 for write strobe, this needs to use timer 4 or above...
-#define TIMER_NUM 4
-#define TIMER_ISR TC4_Handler
+#if defined(ARDUINO_ARCH_SAMD) && !LV_TICK_CUSTOM // -------------------
 
-// Interrupt service routine for zerotimer object
-void TIMER_ISR(void) { Adafruit_ZeroTimer::timerHandler(TIMER_NUM); }
+// Interrupt service routine for zerotimer object (timer from board profile)
+void LVGL_BOARD_TIMER_ISR(void) {
+  Adafruit_ZeroTimer::timerHandler(LVGL_BOARD_TIMER_NUM);
+}
 
 // Timer compare match 0 callback -- invokes LittlevGL timekeeper.
 static void timerCallback0(void) { lv_tick_inc(lv_tick_interval_ms); }
 
+static Adafruit_ZeroTimer *zerotimer = NULL;
+
 #elif defined(ESP32) // ------------------------------------------------
 // The following preprocessor code segments are based around the LVGL example
 // project for ESP32:
@@ -36,34 +39,174 @@ static void timerCallback0(void) { lv_tick_inc(lv_tick_interval_ms); }
 static SemaphoreHandle_t xGuiSemaphore = NULL;
 static TaskHandle_t g_lvgl_task_handle;
 
+// GUI task setup, see setTaskConfig(). Pinned to core 1 where there are
+// two, leaving core 0 to WiFi.
+static LvGLTaskConfig gui_task_config = {1024 * 8, 5,
+                                         (portNUM_PROCESSORS > 1) ? 1 : 0, 16};
+
+// UI commands posted by other tasks, see post()
+typedef struct {
+  LvGLCommandFn fn;
+  lv_obj_t *obj;
+  intptr_t arg;
+  bool coalesce;
+} LvGLCommand;
+static QueueHandle_t command_queue = NULL;
+static LvGLCommand *command_batch = NULL; // Drained here, depth entries
+
+// Run the commands posted since the last pass, in order. Of those marked
+// to coalesce, only the last for any one function and object is run.
+static void lvgl_run_commands(void) {
+  if (!command_queue) {
+    return;
+  }
+  UBaseType_t n = 0;
+  while ((n < gui_task_config.queue_depth) &&
+         (xQueueReceive(command_queue, &command_batch[n], 0) == pdTRUE)) {
+    n++;
+  }
+  for (UBaseType_t i = 0; i < n; i++) {
+    LvGLCommand *cmd = &command_batch[i];
+    bool superseded = false;
+    for (UBaseType_t j = i + 1; cmd->coalesce && (j < n); j++) {
+      if ((command_batch[j].fn == cmd->fn) &&
+          (command_batch[j].obj == cmd->obj)) {
+        superseded = true;
+        break;
+      }
+    }
+    if (!superseded) {
+      cmd->fn(cmd->obj, cmd->arg);
+    }
+  }
+}
+
+#if !LV_TICK_CUSTOM
+static esp_timer_handle_t lv_tick_timer;
+
 // Periodic timer handler
 // NOTE: We use the IRAM_ATTR here to place this code into RAM rather than flash
 static void IRAM_ATTR lv_tick_handler(void *arg) {
   (void)arg;
   lv_tick_inc(lv_tick_interval_ms);
 }
+#endif
 
 // Pinned task used to update the GUI, called by FreeRTOS
 static void gui_task(void *args) {
+  uint32_t ms = 0;
   while (1) {
-    // Delay 1 tick (follows lv_tick_interval_ms)
-    vTaskDelay(pdMS_TO_TICKS(lv_tick_interval_ms));
+    // Sleep until a notification (wake(), lvgl_release() or a touch
+    // interrupt) says there's something to do, or until...
+#if LV_TICK_CUSTOM
+    // ...the next LittlevGL timer is due
+    TickType_t wait = (ms == LV_NO_TIMER_READY)
+                          ? portMAX_DELAY
+                          : max(pdMS_TO_TICKS(ms), (TickType_t)1);
+#else
+    // ...the next tick (follows lv_tick_interval_ms)
+    TickType_t wait = pdMS_TO_TICKS(lv_tick_interval_ms);
+#endif
+    ulTaskNotifyTake(pdTRUE, wait);
 
     // Try to take the semaphore, call lvgl task handler function on success
     if (pdTRUE == xSemaphoreTake(xGuiSemaphore, portMAX_DELAY)) {
-      lv_task_handler();
+      lvgl_run_commands();
+      ms = lvgl_timer_pass();
       xSemaphoreGive(xGuiSemaphore);
     }
   }
 }
 
+// Wake the GUI task from an interrupt
+static void IRAM_ATTR lvgl_wake_from_isr(void) {
+  BaseType_t woken = pdFALSE;
+  if (g_lvgl_task_handle) {
+    vTaskNotifyGiveFromISR(g_lvgl_task_handle, &woken);
+  }
+  if (woken) {
+    portYIELD_FROM_ISR();
+  }
+}
+
+/**
+ * @brief Set up the GUI task that runs LittlevGL on ESP32. It's shared by
+ * all displays, so this must be called before the first begin().
+ *
+ * @param config Stack size, priority and core for the task
+ * @return true on success, false if the task is already running
+ */
+bool Adafruit_LvGL_Glue::setTaskConfig(const LvGLTaskConfig *config) {
+  if (g_lvgl_task_handle) {
+    return false;
+  }
+  gui_task_config = *config;
+  return true;
+}
+
+/**
+ * @brief Wake the GUI task right away, instead of at its next tick or
+ * timer deadline, e.g. after changing widgets in response to a network
+ * event. Safe to call from any task or interrupt. lvgl_release() does
+ * this already.
+ */
+void IRAM_ATTR Adafruit_LvGL_Glue::wake(void) {
+  if (xPortInIsrContext()) {
+    lvgl_wake_from_isr();
+  } else if (g_lvgl_task_handle) {
+    xTaskNotifyGive(g_lvgl_task_handle);
+  }
+}
+
+/**
+ * @brief Queue a UI update for the GUI task to run before its next
+ * LittlevGL pass, as fn(obj, arg). Unlike lvgl_acquire(), this never
+ * waits on the GUI task (it may be partway through a long refresh), so
+ * it suits network and sensor tasks, and is safe from interrupts too.
+ *
+ * @param fn Function to run in the GUI task; it may call any lv_ function
+ * @param obj Object to update, passed to fn
+ * @param arg Value passed to fn, e.g. a new slider value. A pointer must
+ * stay valid until fn runs.
+ * @param coalesce If true, and another coalescing command with the same
+ * fn and obj is posted before this one runs, only the later one runs
+ * (e.g. a sensor reading that updates faster than the display)
+ * @return true if queued, false if the queue is full (or disabled, see
+ * setTaskConfig()) and the command was dropped
+ */
+bool IRAM_ATTR Adafruit_LvGL_Glue::post(LvGLCommandFn fn, lv_obj_t *obj,
+                                        intptr_t arg, bool coalesce) {
+  if (!command_queue) {
+    return false;
+  }
+  LvGLCommand cmd = {fn, obj, arg, coalesce};
+  if (xPortInIsrContext()) {
+    BaseType_t woken = pdFALSE;
+    if (xQueueSendFromISR(command_queue, &cmd, &woken) != pdTRUE) {
+      return false;
+    }
+    if (g_lvgl_task_handle) {
+      vTaskNotifyGiveFromISR(g_lvgl_task_handle, &woken);
+    }
+    if (woken) {
+      portYIELD_FROM_ISR();
+    }
+    return true;
+  }
+  if (xQueueSend(command_queue, &cmd, 0) != pdTRUE) {
+    return false;
+  }
+  wake();
+  return true;
+}
+
 /**
  * @brief Locks LVGL resource to prevent memory corrupton on ESP32.
  * NOTE: This function MUST be called PRIOR to a LVGL function (`lv_`) call.
  */
 void Adafruit_LvGL_Glue::lvgl_acquire(void) {
   TaskHandle_t task = xTaskGetCurrentTaskHandle();
-  if (g_lvgl_task_handle != task) {
+  if (xGuiSemaphore && (g_lvgl_task_handle != task)) { // None before begin()
     xSemaphoreTake(xGuiSemaphore, portMAX_DELAY);
   }
 }
@@ -74,21 +217,21 @@ void Adafruit_LvGL_Glue::lvgl_acquire(void) {
  */
 void Adafruit_LvGL_Glue::lvgl_release(void) {
   TaskHandle_t task = xTaskGetCurrentTaskHandle();
-  if (g_lvgl_task_handle != task) {
+  if (xGuiSemaphore && (g_lvgl_task_handle != task)) {
     xSemaphoreGive(xGuiSemaphore);
+    wake(); // Whatever changed, draw it now (if the GUI task is running)
   }
 }
 
-#elif defined(NRF52_SERIES) // -----------------------------------------
+#elif defined(NRF52_SERIES) && !LV_TICK_CUSTOM // ----------------------
 
-#define TIMER_ID NRF_TIMER4
-#define TIMER_IRQN TIMER4_IRQn
-#define TIMER_ISR TIMER4_IRQHandler
+#define TIMER_ID LVGL_BOARD_TIMER // Timer and IRQ from board profile
+#define TIMER_IRQN LVGL_BOARD_TIMER_IRQN
 #define TIMER_FREQ 16000000
 
 extern "C" {
 // Timer interrupt service routine
-void TIMER_ISR(void) {
+void LVGL_BOARD_TIMER_ISR(void) {
   if (TIMER_ID->EVENTS_COMPARE[0]) {
     TIMER_ID->EVENTS_COMPARE[0] = 0;
   }
@@ -96,6 +239,222 @@ void TIMER_ISR(void) {
 }
 }
 
+#elif defined(ADAFRUIT_LVGL_GLUE_HOST) // -------------------------------
+
+// Host builds (see extras/host) have no hardware timer to borrow, so
+// LittlevGL reads millis() directly through LV_TICK_CUSTOM instead.
+#if !LV_TICK_CUSTOM
+#error "Host builds require LV_TICK_CUSTOM in lv_conf.h"
+#endif
+
+#endif
+
+#if !defined(ESP32)
+// Set by interrupts with news for LittlevGL, ends a service() sleep early
+static volatile bool lvgl_wake = false;
+
+#if defined(NRF52_SERIES)
+// The Arduino loop() is a FreeRTOS task here, service() sleeps in it
+static TaskHandle_t lvgl_idle_task = NULL;
+#endif
+
+static void lvgl_wake_from_isr(void) {
+  lvgl_wake = true;
+#if defined(NRF52_SERIES)
+  if (lvgl_idle_task) {
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(lvgl_idle_task, &woken);
+    portYIELD_FROM_ISR(woken);
+  }
+#endif
+}
+
+/**
+ * @brief End a service() sleep right away, e.g. from an interrupt that
+ * changed something LittlevGL should draw. Safe to call from interrupts.
+ */
+void Adafruit_LvGL_Glue::wake(void) {
+#if defined(NRF52_SERIES)
+  if (!__get_IPSR()) { // Called from a task
+    lvgl_wake = true;
+    if (lvgl_idle_task) {
+      xTaskNotifyGive(lvgl_idle_task);
+    }
+    return;
+  }
+#endif
+  lvgl_wake_from_isr();
+}
+#endif
+
+// Start LittlevGL's tick source (and, on ESP32, the task that runs it).
+// There's only one of these however many displays are in use.
+static LvGLStatus lvgl_tick_begin(void) {
+#if defined(ARDUINO_ARCH_SAMD) && !LV_TICK_CUSTOM // -------------------
+
+  LvGLStatus status = LVGL_ERR_ALLOC;
+  if ((zerotimer = new Adafruit_ZeroTimer(LVGL_BOARD_TIMER_NUM))) {
+    uint16_t divider = 1;
+    uint16_t compare = 0;
+    tc_clock_prescaler prescaler = TC_CLOCK_PRESCALER_DIV1;
+
+    status = LVGL_OK; // We're prob good now, but one more test...
+
+    int freq = 1000 / lv_tick_interval_ms;
+
+    if ((freq < (48000000 / 2)) && (freq > (48000000 / 65536))) {
+      divider = 1;
+      prescaler = TC_CLOCK_PRESCALER_DIV1;
+    } else if (freq > (48000000 / 65536 / 2)) {
+      divider = 2;
+      prescaler = TC_CLOCK_PRESCALER_DIV2;
+    } else if (freq > (48000000 / 65536 / 4)) {
+      divider = 4;
+      prescaler = TC_CLOCK_PRESCALER_DIV4;
+    } else if (freq > (48000000 / 65536 / 8)) {
+      divider = 8;
+      prescaler = TC_CLOCK_PRESCALER_DIV8;
+    } else if (freq > (48000000 / 65536 / 16)) {
+      divider = 16;
+      prescaler = TC_CLOCK_PRESCALER_DIV16;
+    } else if (freq > (48000000 / 65536 / 64)) {
+      divider = 64;
+      prescaler = TC_CLOCK_PRESCALER_DIV64;
+    } else if (freq > (48000000 / 65536 / 256)) {
+      divider = 256;
+      prescaler = TC_CLOCK_PRESCALER_DIV256;
+    } else {
+      status = LVGL_ERR_TIMER; // Invalid frequency
+    }
+
+    if (status == LVGL_OK) {
+      compare = (48000000 / divider) / freq;
+      // Initialize timer
+      zerotimer->configure(prescaler, TC_COUNTER_SIZE_16BIT,
+                           TC_WAVE_GENERATION_MATCH_PWM);
+      zerotimer->setCompare(0, compare);
+      zerotimer->setCallback(true, TC_CALLBACK_CC_CHANNEL0, timerCallback0);
+      zerotimer->enable(true);
+    }
+  }
+  if (status != LVGL_OK) {
+    delete zerotimer;
+    zerotimer = NULL;
+  }
+  return status;
+
+#elif defined(ESP32) // ------------------------------------------------
+#if !LV_TICK_CUSTOM
+  // Create a periodic timer to call `lv_tick_handler`
+  const esp_timer_create_args_t periodic_timer_args = {
+      .callback = &lv_tick_handler, .name = "lv_tick_handler"};
+  ESP_ERROR_CHECK(esp_timer_create(&periodic_timer_args, &lv_tick_timer));
+#endif
+
+  // Create a new mutex
+  xGuiSemaphore = xSemaphoreCreateMutex();
+  if (xGuiSemaphore == NULL) {
+    return LVGL_ERR_MUTEX; // failure
+  }
+
+  if (gui_task_config.queue_depth) {
+    command_batch = (LvGLCommand *)malloc(gui_task_config.queue_depth *
+                                          sizeof(LvGLCommand));
+    command_queue =
+        xQueueCreate(gui_task_config.queue_depth, sizeof(LvGLCommand));
+    if (!command_batch || !command_queue) {
+      return LVGL_ERR_ALLOC;
+    }
+  }
+
+  // Start the LVGL gui task, pinned per setTaskConfig()
+  if (xTaskCreatePinnedToCore(
+          gui_task, "lvgl_gui", gui_task_config.stack_size, NULL,
+          gui_task_config.priority, &g_lvgl_task_handle,
+          (gui_task_config.core < 0) ? tskNO_AFFINITY
+                                     : gui_task_config.core) != pdPASS)
+    return LVGL_ERR_TASK; // failure
+
+#if !LV_TICK_CUSTOM
+  // Start timer
+  ESP_ERROR_CHECK(
+      esp_timer_start_periodic(lv_tick_timer, lv_tick_interval_ms * 1000));
+#endif
+  return LVGL_OK;
+
+#elif defined(NRF52_SERIES) && !LV_TICK_CUSTOM // ----------------------
+
+  TIMER_ID->TASKS_STOP = 1;               // Stop timer
+  TIMER_ID->MODE = TIMER_MODE_MODE_Timer; // Not counter mode
+  TIMER_ID->TASKS_CLEAR = 1;
+  TIMER_ID->BITMODE = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
+  TIMER_ID->PRESCALER = 0; // 1:1 prescale (16 MHz)
+  TIMER_ID->INTENSET = TIMER_INTENSET_COMPARE0_Enabled
+                       << TIMER_INTENSET_COMPARE0_Pos; // Event 0 int
+  TIMER_ID->CC[0] = TIMER_FREQ / (lv_tick_interval_ms * 1000);
+
+  NVIC_DisableIRQ(TIMER_IRQN);
+  NVIC_ClearPendingIRQ(TIMER_IRQN);
+  NVIC_SetPriority(TIMER_IRQN, 2); // Lower priority than soft device
+  NVIC_EnableIRQ(TIMER_IRQN);
+
+  TIMER_ID->TASKS_START = 1; // Start timer
+
+  return LVGL_OK;
+
+#else // ----------------------------------------------------------------
+
+  return LVGL_OK; // Tick comes from millis() via LV_TICK_CUSTOM
+
+#endif
+}
+
+// Stop or restart the tick source set up by lvgl_tick_begin(). On ESP32
+// the caller must hold the LVGL lock, so the GUI task is never suspended
+// partway through a refresh.
+static void lvgl_tick_enable(bool enable) {
+#if defined(ARDUINO_ARCH_SAMD) && !LV_TICK_CUSTOM
+  zerotimer->enable(enable);
+#elif defined(ESP32)
+  if (enable) {
+#if !LV_TICK_CUSTOM
+    esp_timer_start_periodic(lv_tick_timer, lv_tick_interval_ms * 1000);
+#endif
+    vTaskResume(g_lvgl_task_handle);
+  } else {
+#if !LV_TICK_CUSTOM
+    esp_timer_stop(lv_tick_timer);
+#endif
+    if (xTaskGetCurrentTaskHandle() != g_lvgl_task_handle) {
+      vTaskSuspend(g_lvgl_task_handle); // Else it idles until resume()
+    }
+  }
+#elif defined(NRF52_SERIES) && !LV_TICK_CUSTOM
+  if (enable) {
+    TIMER_ID->TASKS_START = 1;
+  } else {
+    TIMER_ID->TASKS_STOP = 1;
+  }
+#endif
+}
+
+// Set once LittlevGL itself and its tick source are up; any further glue
+// instances only add a display (and touchscreen) to them. The tick only
+// runs while at least one display is awake (begun and not suspended).
+static bool lvgl_initialized = false;
+static bool lvgl_tick_running = false;
+static uint8_t lvgl_awake = 0;
+
+#if (LVGL_VERSION_MAJOR == 8) && (LVGL_VERSION_MINOR < 3)
+// LittlevGL 8.2 can't remove an input device; this is what 8.3's
+// lv_indev_delete() does. (The list head is declared in lv_gc.h, which
+// isn't part of lvgl.h.)
+extern "C" lv_ll_t _lv_indev_ll;
+static void lv_indev_delete(lv_indev_t *indev) {
+  lv_timer_del(indev->driver->read_timer);
+  _lv_ll_remove(&_lv_indev_ll, indev);
+  lv_mem_free(indev);
+}
 #endif
 
 // TOUCHSCREEN STUFF -------------------------------------------------------
@@ -112,17 +471,713 @@ void TIMER_ISR(void) {
 #define ADC_YMIN 240
 #define ADC_YMAX 840
 
+// Input device read period when the STMPE610 interrupt is in use. Idle
+// reads cost only a flag check then, so they can be far more frequent than
+// LV_INDEV_DEF_READ_PERIOD, for quicker response to a new touch.
+#define TOUCH_IRQ_READ_PERIOD 10 // ms
+
+#if defined(ESP32)
+#define TOUCH_ISR_ATTR IRAM_ATTR
+#else
+#define TOUCH_ISR_ATTR
+#endif
+
+// Glue instances whose STMPE610 INT pins are attached, one ISR each
+// (attachInterrupt() callbacks take no argument on most cores). Further
+// touchscreens are polled.
+#define TOUCH_IRQ_SLOTS 2
+static Adafruit_LvGL_Glue *touch_irq_glue[TOUCH_IRQ_SLOTS] = {NULL};
+
+// STMPE610 touch-detect interrupt: just flag the glue to read the FIFO
+// next time LittlevGL polls, instead of it hitting the SPI bus every time
+static void TOUCH_ISR_ATTR touch_isr0(void) {
+  if (touch_irq_glue[0]) {
+    touch_irq_glue[0]->touchInterrupt();
+    lvgl_wake_from_isr();
+  }
+}
+
+static void TOUCH_ISR_ATTR touch_isr1(void) {
+  if (touch_irq_glue[1]) {
+    touch_irq_glue[1]->touchInterrupt();
+    lvgl_wake_from_isr();
+  }
+}
+
+static void (*const touch_isr[TOUCH_IRQ_SLOTS])(void) = {touch_isr0,
+                                                         touch_isr1};
+
+// Touch controller kind: fixed by the board profile, else set by begin()
+#if LVGL_BOARD_TOUCH == LVGL_BOARD_TOUCH_ADC
+#define TOUCH_IS_ADC true
+#elif LVGL_BOARD_TOUCH == LVGL_BOARD_TOUCH_STMPE610
+#define TOUCH_IS_ADC false
+#else
+#define TOUCH_IS_ADC is_adc_touch
+#endif
+
 static void touchscreen_read(struct _lv_indev_drv_t *indev_drv,
                              lv_indev_data_t *data) {
-  static lv_coord_t last_x = 0, last_y = 0;
-  static uint8_t release_count = 0;
-
   // Get pointer to glue object from indev user data
-  Adafruit_LvGL_Glue *glue = (Adafruit_LvGL_Glue *)indev_drv->user_data;
-  Adafruit_SPITFT *disp = glue->display;
+  ((Adafruit_LvGL_Glue *)indev_drv->user_data)->readTouch(data);
+}
+
+// Convert a raw touch sample to screen coordinates: one fixed-point 2x3
+// affine transform, with rotation and axis flips already folded in. Sums
+// are 64-bit: a 16.16 coefficient times a 12-bit reading can pass 2^31.
+// Results are clamped to lv_coord_t rather than wrapping around.
+static inline lv_coord_t calibration_row(int32_t a, int32_t b, int32_t c,
+                                         int32_t raw_x, int32_t raw_y) {
+  int64_t v = ((int64_t)a * raw_x + (int64_t)b * raw_y + c) >> 16;
+  return (v < -32768) ? -32768 : (v > 32767) ? 32767 : (lv_coord_t)v;
+}
+
+static inline void apply_calibration(const LvGLTouchCalibration *cal,
+                                     int32_t raw_x, int32_t raw_y,
+                                     lv_coord_t *x, lv_coord_t *y) {
+  *x = calibration_row(cal->a, cal->b, cal->c, raw_x, raw_y);
+  *y = calibration_row(cal->d, cal->e, cal->f, raw_x, raw_y);
+}
+
+// Fill one row of a calibration matrix for a screen axis that follows raw
+// axis `axis` (0 = raw X, 1 = raw Y) linearly from raw_min..raw_max to
+// 0..size-1, or size-1..0 if inverted.
+static void calibration_axis(int32_t row[3], uint8_t axis, bool invert,
+                             int32_t raw_min, int32_t raw_max, int32_t size) {
+  int32_t scale = ((size - 1) << 16) / (raw_max - raw_min);
+  row[0] = row[1] = 0;
+  if (invert) {
+    row[axis] = -scale;
+    row[2] = raw_max * scale;
+  } else {
+    row[axis] = scale;
+    row[2] = -raw_min * scale;
+  }
+}
+
+// TICKLESS OPERATION ------------------------------------------------------
+
+static uint32_t lvgl_timer_pass(void) {
+#if LV_TICK_CUSTOM
+  // Touchscreens idle in interrupt mode have their read timers paused;
+  // restart those whose INT has fired since
+  for (uint8_t slot = 0; slot < TOUCH_IRQ_SLOTS; slot++) {
+    if (touch_irq_glue[slot]) {
+      touch_irq_glue[slot]->touchWake();
+    }
+  }
+#endif
+  return lv_timer_handler();
+}
+
+#if LV_TICK_CUSTOM && !defined(ESP32)
+// Sleep up to ms milliseconds, or until an interrupt calls
+// lvgl_wake_from_isr()
+static void lvgl_idle(uint32_t ms) {
+  uint32_t start = millis();
+#if defined(NRF52_SERIES)
+  // FreeRTOS tickless idle does the actual sleeping
+  lvgl_idle_task = xTaskGetCurrentTaskHandle();
+  if (!lvgl_wake) {
+    ulTaskNotifyTake(pdTRUE, (ms == LV_NO_TIMER_READY) ? portMAX_DELAY
+                                                       : pdMS_TO_TICKS(ms));
+  }
+#else
+  while (!lvgl_wake && ((millis() - start) < ms)) {
+#if defined(ARDUINO_ARCH_SAMD)
+    __WFI(); // SysTick wakes this every millisecond at most
+#else
+    delay(1);
+#endif
+  }
+#endif
+  (void)start;
+  lvgl_wake = false;
+}
+#endif
+
+// OTHER LITTLEVGL VITALS --------------------------------------------------
+
+#if LV_COLOR_DEPTH != 16
+#pragma error("LV_COLOR_DEPTH must be 16")
+#endif
+// This isn't necessarily true, don't mention it for now. See notes later.
+// #if LV_COLOR_16_SWAP != 0
+//  #pragma message("Set LV_COLOR_16_SWAP to 0 for best display performance")
+// #endif
+
+// Draw buffer height for LVGL_BUFFER_DEFAULT, and the floor for
+// LVGL_BUFFER_AUTO, comes from the board profile
+#define LV_BUFFER_ROWS LVGL_BOARD_BUFFER_ROWS
+
+// LVGL_BUFFER_AUTO claims at most 1/N of the free heap for draw buffers,
+// leaving the rest for LittlevGL objects (when not in its own pool),
+// WiFi stacks and the like.
+#define LV_BUFFER_AUTO_DIVISOR 2
+
+#if defined(ESP32)
+#include <esp_heap_caps.h>
+#elif defined(ARDUINO_ARCH_SAMD) || defined(NRF52_SERIES)
+#include <malloc.h>
+extern "C" char *sbrk(int incr);
+#if defined(NRF52_SERIES)
+extern "C" char __HeapLimit; // Heap end, from linker script
+#endif
+#endif
+
+// Bounce buffer size (each of two with DMA, one without) for draw
+// buffers in PSRAM, unless set with setMemoryPolicy()
+#define LV_BOUNCE_ROWS 4
+
+// Where a draw buffer may go on ESP32: internal RAM that SPI DMA can read
+// directly, or PSRAM. Other boards have only the one heap.
+#if defined(ESP32)
+#define LV_MEM_CAPS_INTERNAL (MALLOC_CAP_DMA | MALLOC_CAP_8BIT)
+#define LV_MEM_CAPS_EXTERNAL (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+#endif
+
+static void *lvgl_buf_alloc(size_t bytes, bool external) {
+#if defined(ESP32)
+  return heap_caps_malloc(bytes, external ? LV_MEM_CAPS_EXTERNAL
+                                          : LV_MEM_CAPS_INTERNAL);
+#else
+  return malloc(bytes);
+#endif
+}
+
+static bool lvgl_has_psram(void) {
+#if defined(ESP32) && LVGL_BOARD_PSRAM
+  return heap_caps_get_free_size(LV_MEM_CAPS_EXTERNAL) > 0;
+#else
+  return false;
+#endif
+}
+
+// Estimate how many bytes a single allocation could get right now.
+static uint32_t lvgl_free_heap(bool external) {
+#if defined(ESP32)
+  return heap_caps_get_largest_free_block(external ? LV_MEM_CAPS_EXTERNAL
+                                                   : LV_MEM_CAPS_INTERNAL);
+#elif defined(ARDUINO_ARCH_SAMD)
+  // Heap grows up toward the stack; unused gap plus freed blocks
+  char top;
+  return (&top - sbrk(0)) + mallinfo().fordblks;
+#elif defined(NRF52_SERIES)
+  // Stacks are FreeRTOS tasks on the heap here, so use the linker limit
+  return (&__HeapLimit - sbrk(0)) + mallinfo().fordblks;
+#else
+  return 256 * 1024; // Host builds: pretend to be a SAMD51-class board
+#endif
+}
+
+// This is the flush function required for LittlevGL screen updates.
+// It receives a bounding rect and an array of pixel data (conveniently
+// already in 565 format, so the Earth was lucky there).
+static void lv_flush_callback(lv_disp_drv_t *disp, const lv_area_t *area,
+                              lv_color_t *color_p) {
+  // Get pointer to glue object from display driver user data
+  ((Adafruit_LvGL_Glue *)disp->user_data)->flush(area, color_p);
+}
+
+// LittlevGL calls this while it waits on a buffer that's being flushed.
+// The DMA-complete interrupt in Adafruit_SPITFT clears dmaBusy(), at which
+// point the buffer is handed back without ever blocking in dmaWait().
+static void lv_wait_callback(lv_disp_drv_t *disp) {
+  ((Adafruit_LvGL_Glue *)disp->user_data)->flushPoll();
+}
+
+// LittlevGL calls this before each software draw operation. Nothing is
+// waited on; it's a frequent, cheap point during rendering to start the
+// next chunk of a split transfer (see Adafruit_LvGL_Glue::setBusChunk()).
+static void lv_gpu_wait_callback(lv_disp_drv_t *disp) {
+  ((Adafruit_LvGL_Glue *)disp->user_data)->flushContinue();
+}
+
+// BYTE SWAPPING -----------------------------------------------------------
+
+// Displays want RGB565 big-endian, LittlevGL renders it little-endian
+// (unless LV_COLOR_16_SWAP is set, as on PyPortal). Adafruit_SPITFT can
+// swap per pixel as it sends, but that's done one pixel at a time, and on
+// some paths prevents bulk transfers. Swapping the whole draw buffer here,
+// two pixels per 32-bit word, lets writePixels() always take its fastest
+// big-endian path.
+
+// Word type that may alias the uint16_t pixel buffer
+typedef uint32_t __attribute__((__may_alias__)) swap_word_t;
+
+static inline uint32_t swap_word(uint32_t w) {
+#if defined(__arm__)
+  // REV16 swaps both halfwords in one cycle (ARMv6-M and up: M0+ and M4)
+  __asm__("rev16 %0, %1" : "=r"(w) : "r"(w));
+  return w;
+#else
+  return ((w & 0xFF00FF00) >> 8) | ((w & 0x00FF00FF) << 8);
+#endif
+}
+
+// DIRTY AREA COALESCING ---------------------------------------------------
+
+// Default cost of one extra flush (address window, DMA setup and
+// LittlevGL's per-area render setup), in pixel-equivalents. Areas are
+// merged if sending the extra pixels of the combined window is cheaper.
+#define LV_FLUSH_COST_DEFAULT 256
+
+// Replaces the callback of LittlevGL's display refresh timer, to merge the
+// invalidated areas before LittlevGL's own (lossless-only) join pass runs.
+// Suspended displays skip refreshes, keeping their invalidated areas.
+static void lv_refr_timer_callback(lv_timer_t *timer) {
+  lv_disp_t *disp = (lv_disp_t *)timer->user_data;
+  Adafruit_LvGL_Glue *glue = (Adafruit_LvGL_Glue *)disp->driver->user_data;
+  if (!glue->isSuspended()) {
+    glue->coalesceAreas(disp);
+    _lv_disp_refr_timer(timer);
+  }
+#if LV_TICK_CUSTOM
+  // Tickless: nothing left to draw, so finish the last transfer and stop
+  // polling until something is invalidated (see lv_rounder_callback())
+  if (glue->isSuspended() || !disp->inv_p) {
+    glue->flushWait();
+    lv_timer_pause(timer);
+  }
+#endif
+}
 
-  if (glue->is_adc_touch) {
-    TouchScreen *touch = (TouchScreen *)glue->touchscreen;
+#if LV_TICK_CUSTOM
+// LittlevGL calls this for every invalidated area; the area is left as-is,
+// it's only a hook to restart the display's paused refresh timer.
+static void lv_rounder_callback(lv_disp_drv_t *drv, lv_area_t *area) {
+  lv_disp_t *disp = ((Adafruit_LvGL_Glue *)drv->user_data)->getDisplay();
+  if (disp) {
+    lv_timer_resume(disp->refr_timer);
+  }
+}
+#endif
+
+#if (LV_USE_LOG)
+// Optional LittlevGL debug print function, writes to Serial if debug is
+// enabled when calling glue begin() function.
+static void lv_debug(const char *buf) { Serial.println(buf); }
+#endif
+
+// SHARED BUS ARBITRATION --------------------------------------------------
+
+// Default largest single display transfer, in pixels (8 KB, a couple of
+// milliseconds at typical SPI rates). Default-sized draw buffers are
+// smaller than this, so only larger buffers are ever split.
+#define LV_BUS_CHUNK_DEFAULT 4096
+
+// Glue instance whose display SPI transaction is open, if any. Displays
+// may share a bus, so one finishes its transfers before another starts.
+static Adafruit_LvGL_Glue *bus_display = NULL;
+
+// Device that last used the bus. If it asks again, there's nothing to
+// wait for.
+static LvGLBusClient bus_owner = LVGL_BUS_NONE;
+
+// Devices with a higher priority than the display get the bus at the next
+// chunk boundary, others once the display's current area is sent.
+static uint8_t bus_priority[LVGL_BUS_CLIENTS] = {0, 1, 3, 2};
+
+/**
+ * @brief Set a device's priority on the display's SPI bus. When touch or
+ * SD access needs the bus mid-transfer, a device with a higher priority
+ * than LVGL_BUS_DISPLAY takes it as soon as the current chunk is sent (see
+ * setBusChunk()); otherwise it waits for the whole area. Defaults are
+ * display 1, SD 2, touch 3.
+ *
+ * @param client LVGL_BUS_DISPLAY, LVGL_BUS_TOUCH or LVGL_BUS_SD
+ * @param priority Priority, higher preempts lower
+ */
+void Adafruit_LvGL_Glue::setBusPriority(LvGLBusClient client,
+                                        uint8_t priority) {
+  if ((client > LVGL_BUS_NONE) && (client < LVGL_BUS_CLIENTS)) {
+    bus_priority[client] = priority;
+  }
+}
+
+/**
+ * @brief Get the display's SPI bus for another device. Any display
+ * transfer in progress either pauses after its current chunk or finishes,
+ * depending on priority (see setBusPriority()). Returns at once if the
+ * display isn't using the bus. Internal callbacks call this before each
+ * touchscreen or SD access; user code talking to other devices on the same
+ * bus can too. Compiles to nothing on boards whose profile sets
+ * LVGL_BOARD_SHARED_BUS to 0.
+ *
+ * @param client LVGL_BUS_TOUCH, LVGL_BUS_SD, or another device ID
+ */
+void Adafruit_LvGL_Glue::busAcquire(LvGLBusClient client) {
+#if LVGL_BOARD_SHARED_BUS // Else display has its own bus, nothing to wait on
+  Adafruit_LvGL_Glue *glue = bus_display;
+  if ((bus_owner != client) && glue) {
+    uint32_t t0 = micros();
+    if (bus_priority[client] > bus_priority[LVGL_BUS_DISPLAY]) {
+      glue->busYield();
+    } else {
+      glue->flushWait();
+    }
+    glue->stats.bus_wait_us += micros() - t0;
+  }
+#endif
+  bus_owner = client;
+}
+
+/**
+ * @brief Set the largest display transfer sent in one go. Bigger areas
+ * are split at row boundaries, and touch or SD access can take the bus
+ * between the pieces (see busAcquire()), rather than waiting for the
+ * whole area. Has no effect without DMA, or with PSRAM draw buffers (sent
+ * in bounce buffer pieces already).
+ *
+ * @param pixels Chunk size in pixels (default 4096), rounded down to whole
+ * rows of each area; 0 sends whole areas
+ */
+void Adafruit_LvGL_Glue::setBusChunk(uint32_t pixels) { bus_chunk = pixels; }
+
+// Open the display's SPI transaction, first finishing with any other
+// display on the bus
+void Adafruit_LvGL_Glue::busOpen(void) {
+  if (bus_display && (bus_display != this)) {
+    bus_display->flushWait();
+  }
+  display->startWrite();
+  write_open = true;
+  bus_display = this;
+  bus_owner = LVGL_BUS_DISPLAY;
+}
+
+// Close the display's SPI transaction
+void Adafruit_LvGL_Glue::busClose(void) {
+  display->endWrite();
+  write_open = false;
+  bus_display = NULL;
+  bus_owner = LVGL_BUS_NONE;
+}
+
+// Let another device have the bus as soon as the current chunk is sent.
+// The rest of the area follows once the display gets the bus back.
+void Adafruit_LvGL_Glue::busYield(void) {
+  dmaWait();
+  if (flush_pending && !chunk_left) {
+    flushDone(); // Area finished anyway
+  }
+  if (write_open) {
+    busClose();
+    if (flush_pending) {
+      stats.bus_yields++;
+    }
+  }
+}
+
+// Start sending the next chunk of the area being flushed. If another
+// device had the bus meanwhile, reopen the transaction and address the
+// area's remaining rows.
+void Adafruit_LvGL_Glue::sendChunk(void) {
+  uint16_t width = chunk_area.x2 - chunk_area.x1 + 1;
+  if (!write_open) {
+    busOpen();
+    display->setAddrWindow(chunk_area.x1, chunk_area.y1, width,
+                           chunk_area.y2 - chunk_area.y1 + 1);
+  }
+  uint32_t n = (chunk_left < chunk_pixels) ? chunk_left : chunk_pixels;
+  // A direct mode frame is kept for the next refresh, so it's never
+  // swapped in place; Adafruit_SPITFT swaps as it sends instead
+  bool swap = !LV_COLOR_16_SWAP && swap_pixels &&
+              !(LVGL_BOARD_DIRECT && lv_disp_drv.direct_mode);
+  if (swap) { // Swapped chunk by chunk, interleaved with sending
+    swapBytes(chunk_next, n);
+  }
+  display->writePixels(chunk_next, n, false, LV_COLOR_16_SWAP || swap);
+  chunk_next += (n / width) * chunk_stride;
+  chunk_left -= n;
+  chunk_area.y1 += n / width;
+}
+
+// GLUE LIB FUNCTIONS ------------------------------------------------------
+
+/**
+ * @brief Send one rendered area to the display. Called by LittlevGL's flush
+ * callback.
+ *
+ * With DMA, the transfer is only started here; LittlevGL isn't told the
+ * buffer is free until the transfer completes (see flushPoll()), so it can
+ * render into the other buffer meanwhile instead of stalling. The display's
+ * SPI transaction is left open across all flushes of one refresh, so each
+ * area only costs an address window, not a startWrite()/endWrite() cycle.
+ *
+ * @param area Screen area to update
+ * @param color_p Rendered pixels for the area
+ */
+void Adafruit_LvGL_Glue::flush(const lv_area_t *area, lv_color_t *color_p) {
+  if (suspended) { // Panel asleep, draw buffers maybe parked: drop it
+    frame_open = false;
+    lv_disp_flush_ready(&lv_disp_drv);
+    return;
+  }
+  uint32_t start = micros();
+  if (!frame_open) {
+    // First flush of a refresh that didn't come through the refresh timer
+    // (lv_refr_now()); time it from here, the first area's render unseen
+    frameOpen(start);
+  }
+  // Time since the previous flush not spent waiting on DMA was rendering
+  stats.render_us += (start - render_mark) - (stats.dma_wait_us - wait_mark);
+
+  while (flush_pending) { // Normally not, LittlevGL has already waited
+    dmaWait();
+    flushContinue();
+  }
+  flush_last = lv_disp_flush_is_last(&lv_disp_drv);
+
+  uint16_t width = (area->x2 - area->x1 + 1);
+  uint32_t stride = width; // Pixels from one row's start to the next
+  if (LVGL_BOARD_DIRECT && lv_disp_drv.direct_mode) {
+    // Each area is drawn in place in the whole-screen frame, and LittlevGL
+    // passes the frame; send just the area, from where it is in there
+    area = directArea(area);
+    stride = lv_disp_drv.hor_res;
+    color_p += (uint32_t)area->y1 * stride + area->x1;
+    width = (area->x2 - area->x1 + 1);
+    if (flush_last) {
+      direct_next = 0; // Next refresh, first area
+    }
+  }
+  uint16_t height = (area->y2 - area->y1 + 1);
+  uint32_t pixels = (uint32_t)width * height;
+
+  if (flush_tap) { // Sees pixels before they're swapped for the display
+    if (stride == width) {
+      flush_tap(area, color_p, flush_tap_data);
+    } else {
+      lv_area_t row = *area;
+      for (; row.y1 <= area->y2; row.y1++) {
+        row.y2 = row.y1;
+        flush_tap(&row, &color_p[(row.y1 - area->y1) * stride],
+                  flush_tap_data);
+      }
+    }
+  }
+  if (!write_open) {
+    busOpen();
+  }
+
+  display->setAddrWindow(area->x1, area->y1, width, height);
+  flush_pending = true;
+  chunk_left = 0;
+  if (LVGL_BOARD_PSRAM && lv_bounce_buf) {
+    flushBounce((uint16_t *)color_p, width, pixels, stride);
+  } else {
+    // Split the area if it's large, except the last of a refresh: nothing
+    // would be rendering meanwhile to start the later pieces
+    chunk_pixels = pixels;
+#if defined(USE_SPI_DMA)
+    if (bus_chunk && !flush_last && (pixels > bus_chunk)) {
+      chunk_pixels = (bus_chunk > width) ? (bus_chunk / width) * width : width;
+    }
+#endif
+    if (stride != width) { // Rows aren't contiguous, one at a time
+      chunk_pixels = width;
+    }
+    chunk_area = *area;
+    chunk_next = (uint16_t *)color_p;
+    chunk_left = pixels;
+    chunk_stride = stride;
+    sendChunk();
+    while (flush_last && chunk_left) { // Nothing else would send the rest
+      dmaWait();
+      sendChunk();
+    }
+  }
+
+  stats.flushes++;
+  stats.pixels += pixels;
+  stats.bytes += pixels * sizeof(lv_color_t);
+  render_mark = micros();
+  wait_mark = stats.dma_wait_us;
+  stats.flush_us += render_mark - start;
+
+  flushContinue(); // No DMA (write blocked), or already done
+}
+
+// Send pixels from a PSRAM draw buffer by way of the internal bounce
+// buffer(s), swapping there rather than in PSRAM. With DMA, the next chunk
+// is copied while the last one is still being sent. Rows of width pixels
+// start stride pixels apart in src (more than width in direct mode).
+void Adafruit_LvGL_Glue::flushBounce(const uint16_t *src, uint16_t width,
+                                     uint32_t pixels, uint32_t stride) {
+  uint16_t *chunk = lv_bounce_buf;
+  uint32_t run = (stride == width) ? pixels : width; // Contiguous pixels
+  uint32_t col = 0; // Position in that run
+  while (pixels) {
+    uint32_t n = (pixels < bounce_pixels) ? pixels : bounce_pixels;
+    for (uint32_t i = 0; i < n;) {
+      uint32_t len = LV_MIN(n - i, run - col);
+      memcpy(&chunk[i], &src[col], len * sizeof(uint16_t));
+      i += len;
+      col += len;
+      if (col == run) {
+        src += stride;
+        col = 0;
+      }
+    }
+    if (!LV_COLOR_16_SWAP && swap_pixels) {
+      swapBytes(chunk, n);
+    }
+    dmaWait(); // Previous chunk, from the other bounce buffer
+    display->writePixels(chunk, n, false, LV_COLOR_16_SWAP || swap_pixels);
+    pixels -= n;
+#if defined(USE_SPI_DMA)
+    chunk = (chunk == lv_bounce_buf) ? &lv_bounce_buf[bounce_pixels]
+                                     : lv_bounce_buf;
+#endif
+  }
+}
+
+// Direct mode: which area LittlevGL just drew. It draws the display's
+// invalidated areas in order, skipping any joined into others, and flushes
+// after each. Falls back on the whole screen if they've run out.
+const lv_area_t *Adafruit_LvGL_Glue::directArea(const lv_area_t *screen) {
+  while ((direct_next < lv_disp->inv_p) &&
+         lv_disp->inv_area_joined[direct_next]) {
+    direct_next++;
+  }
+  if (direct_next < lv_disp->inv_p) {
+    return &lv_disp->inv_areas[direct_next++];
+  }
+  return screen;
+}
+
+/**
+ * @brief Finish any in-flight display transfer: wait for DMA to complete,
+ * end the display's SPI transaction and return the buffer to LittlevGL.
+ * Internal callbacks use this before sharing the SPI bus with other devices.
+ */
+void Adafruit_LvGL_Glue::flushWait(void) {
+  if (bus_display && (bus_display != this)) {
+    bus_display->flushWait(); // Other display's transfer, same bus maybe
+  }
+  while (flush_pending) {
+    dmaWait();
+    flushContinue();
+  }
+  if (write_open) {
+    busClose();
+  }
+}
+
+/**
+ * @brief If the in-flight display transfer has completed, return its buffer
+ * to LittlevGL. Never blocks; LittlevGL calls this repeatedly (via wait_cb)
+ * while it has nothing to do but wait for a buffer.
+ */
+void Adafruit_LvGL_Glue::flushPoll(void) {
+  if (flush_pending && !wait_start) {
+    wait_start = micros() | 1; // Never 0, that means "not waiting"
+  }
+  flushContinue();
+}
+
+/**
+ * @brief If the display's DMA transfer has completed, start the next chunk
+ * of the area being flushed, or if that was the last, return its buffer to
+ * LittlevGL. Never blocks.
+ */
+void Adafruit_LvGL_Glue::flushContinue(void) {
+  while (flush_pending && !display->dmaBusy()) {
+    if (chunk_left) {
+      sendChunk();
+    } else {
+      flushDone();
+    }
+  }
+}
+
+// Wait on the display's DMA transfer, if any, counting the time blocked
+void Adafruit_LvGL_Glue::dmaWait(void) {
+  if (display->dmaBusy()) {
+    uint32_t t0 = micros();
+    display->dmaWait();
+    stats.dma_wait_us += micros() - t0;
+  }
+}
+
+// The in-flight transfer is done: hand its buffer back to LittlevGL, and
+// close out the refresh if it was the last one
+void Adafruit_LvGL_Glue::flushDone(void) {
+  flush_pending = false;
+  if (wait_start) { // LittlevGL was polling for this buffer
+    stats.dma_wait_us += micros() - wait_start;
+    wait_start = 0;
+  }
+  if (flush_last) {
+    if (write_open) {
+      busClose();
+    }
+
+    frame_open = false;
+    uint32_t frame_us = micros() - frame_start;
+    stats.frames++;
+    frame_us_total += frame_us;
+    if (frame_us < stats.frame_us_min) {
+      stats.frame_us_min = frame_us;
+    }
+    if (frame_us > stats.frame_us_max) {
+      stats.frame_us_max = frame_us;
+    }
+  }
+  lv_disp_flush_ready(&lv_disp_drv);
+}
+
+/**
+ * @brief Take a snapshot of the display pipeline statistics gathered since
+ * begin() or the last reset. Cheap enough to call every frame.
+ *
+ * @param stats Structure to fill in
+ * @param reset If true, start counting afresh after taking the snapshot
+ */
+void Adafruit_LvGL_Glue::getStats(LvGLStats *stats, bool reset) {
+  *stats = this->stats;
+  if (stats->frames) {
+    stats->frame_us_avg = frame_us_total / stats->frames;
+  } else {
+    stats->frame_us_min = 0;
+  }
+  if (reset) {
+    resetStats();
+  }
+}
+
+// Start timing a display refresh at micros() value 'now'
+void Adafruit_LvGL_Glue::frameOpen(uint32_t now) {
+  frame_open = true;
+  frame_start = render_mark = now;
+  wait_mark = stats.dma_wait_us;
+}
+
+/**
+ * @brief Zero the display pipeline statistics
+ */
+void Adafruit_LvGL_Glue::resetStats(void) {
+  memset(&stats, 0, sizeof(stats));
+  stats.frame_us_min = UINT32_MAX;
+  frame_us_total = 0;
+  render_mark = micros();
+  wait_mark = 0;
+}
+
+/**
+ * @brief Read the touchscreen for LittlevGL. Called by the input device's
+ * read callback.
+ *
+ * @param data Pointer state to fill in
+ */
+void Adafruit_LvGL_Glue::readTouch(lv_indev_data_t *data) {
+  if (!touch_cal_custom && (display->getRotation() != touch_cal_rotation)) {
+    defaultTouchCalibration(); // Display was rotated since last time
+  }
+
+  if (TOUCH_IS_ADC) {
+    TouchScreen *touch = (TouchScreen *)touchscreen;
     TSPoint p = touch->getPoint();
     // Serial.printf("%d %d %d\r\n", p.x, p.y, p.z);
     // Having an issue with spurious z=0 results from TouchScreen lib.
@@ -130,71 +1185,52 @@ static void touchscreen_read(struct _lv_indev_drv_t *indev_drv,
     // several successive z=0 results, and only then regard it as
     // a release event (otherwise still touched).
     if (p.z < touch->pressureThreshhold) { // A zero-ish value
-      release_count += (release_count < 255);
-      if (release_count >= 4) {
+      touch_release_count += (touch_release_count < 255);
+      if (touch_release_count >= 4) {
         data->state = LV_INDEV_STATE_REL; // Is REALLY RELEASED
+        touch_filter.reset();
       } else {
         data->state = LV_INDEV_STATE_PR; // Is STILL PRESSED
       }
     } else {
-      release_count = 0;               // Reset release counter
+      touch_release_count = 0;         // Reset release counter
       data->state = LV_INDEV_STATE_PR; // Is PRESSED
-      switch (glue->display->getRotation()) {
-      case 0:
-        last_x = map(p.x, ADC_XMIN, ADC_XMAX, 0, disp->width() - 1);
-        last_y = map(p.y, ADC_YMAX, ADC_YMIN, 0, disp->height() - 1);
-        break;
-      case 1:
-        last_x = map(p.y, ADC_YMAX, ADC_YMIN, 0, disp->width() - 1);
-        last_y = map(p.x, ADC_XMAX, ADC_XMIN, 0, disp->height() - 1);
-        break;
-      case 2:
-        last_x = map(p.x, ADC_XMAX, ADC_XMIN, 0, disp->width() - 1);
-        last_y = map(p.y, ADC_YMIN, ADC_YMAX, 0, disp->height() - 1);
-        break;
-      case 3:
-        last_x = map(p.y, ADC_YMIN, ADC_YMAX, 0, disp->width() - 1);
-        last_y = map(p.x, ADC_XMIN, ADC_XMAX, 0, disp->height() - 1);
-        break;
-      }
+      apply_calibration(&touch_cal, p.x, p.y, &touch_x, &touch_y);
+      touch_filter.process(&touch_x, &touch_y);
     }
-    data->point.x = last_x; // Last-pressed coordinates
-    data->point.y = last_y;
+    data->point.x = touch_x; // Last-pressed coordinates
+    data->point.y = touch_y;
     data->continue_reading = false; // No buffering of ADC touch data
   } else {
     uint8_t fifo; // Number of points in touchscreen FIFO
     bool more = false;
-    Adafruit_STMPE610 *touch = (Adafruit_STMPE610 *)glue->touchscreen;
-    // Before accessing SPI touchscreen, wait on any in-progress
-    // DMA screen transfer to finish (shared bus).
-    disp->dmaWait();
-    disp->endWrite();
+    Adafruit_STMPE610 *touch = (Adafruit_STMPE610 *)touchscreen;
+    if (touch_irq_pin >= 0) {
+      // Interrupt mode: while idle, nothing to read until INT says so.
+      if (!touch_irq_flag && !touch_active) {
+#if LV_TICK_CUSTOM
+        lv_timer_pause(lv_indev_drv.read_timer); // Until touchWake()
+#endif
+        data->state = LV_INDEV_STATE_REL;
+        data->point.x = touch_x;
+        data->point.y = touch_y;
+        data->continue_reading = false;
+        return;
+      }
+      touch_irq_flag = false; // Clear first, so a new edge isn't lost
+    }
+    // Before accessing SPI touchscreen, get the bus from the display
+    // (shared bus).
+    busAcquire(LVGL_BUS_TOUCH);
+    if (touch_irq_pin >= 0) {
+      touch->writeRegister8(STMPE_INT_STA, 0xFF); // Ack, re-arm INT
+    }
     if ((fifo = touch->bufferSize())) { // 1 or more points await
       data->state = LV_INDEV_STATE_PR;  // Is PRESSED
       TS_Point p = touch->getPoint();
       // Serial.printf("%d %d %d\r\n", p.x, p.y, p.z);
-      // On big TFT FeatherWing, raw X axis is flipped??
-      if ((glue->display->width() == 480) || (glue->display->height() == 480)) {
-        p.x = (TS_MINX + TS_MAXX) - p.x;
-      }
-      switch (glue->display->getRotation()) {
-      case 0:
-        last_x = map(p.x, TS_MAXX, TS_MINX, 0, disp->width() - 1);
-        last_y = map(p.y, TS_MINY, TS_MAXY, 0, disp->height() - 1);
-        break;
-      case 1:
-        last_x = map(p.y, TS_MINY, TS_MAXY, 0, disp->width() - 1);
-        last_y = map(p.x, TS_MINX, TS_MAXX, 0, disp->height() - 1);
-        break;
-      case 2:
-        last_x = map(p.x, TS_MINX, TS_MAXX, 0, disp->width() - 1);
-        last_y = map(p.y, TS_MAXY, TS_MINY, 0, disp->height() - 1);
-        break;
-      case 3:
-        last_x = map(p.y, TS_MAXY, TS_MINY, 0, disp->width() - 1);
-        last_y = map(p.x, TS_MAXX, TS_MINX, 0, disp->height() - 1);
-        break;
-      }
+      apply_calibration(&touch_cal, p.x, p.y, &touch_x, &touch_y);
+      touch_filter.process(&touch_x, &touch_y);
       more = (fifo > 1); // true if more in FIFO, false if last point
 #if defined(NRF52_SERIES)
       // Not sure what's up here, but nRF doesn't seem to always poll
@@ -208,63 +1244,521 @@ static void touchscreen_read(struct _lv_indev_drv_t *indev_drv,
 #endif
     } else {                            // FIFO empty
       data->state = LV_INDEV_STATE_REL; // Is RELEASED
+      touch_filter.reset();
+    }
+    touch_active = (data->state == LV_INDEV_STATE_PR);
+
+    data->point.x = touch_x; // Last-pressed coordinates
+    data->point.y = touch_y;
+    data->continue_reading = more;
+  }
+}
+
+// Set up the default touch calibration from the TS_* or ADC_* constants
+// above, for the display's current rotation.
+void Adafruit_LvGL_Glue::defaultTouchCalibration(void) {
+  // Per rotation: the raw axis that screen X follows (0 = raw X, 1 = raw
+  // Y; screen Y follows the other), and whether screen X and Y run against
+  // their raw axes. These are for the STMPE610; ADC touchscreens are mounted
+  // 180 degrees around from it.
+  static const uint8_t rotations[4][3] = {
+      {0, 1, 0}, {1, 0, 0}, {0, 0, 1}, {1, 1, 1}};
+  int32_t raw_min[2], raw_max[2];
+  bool flip_raw_x = false;
+  uint8_t rotation = touch_cal_rotation = display->getRotation();
+
+  if (TOUCH_IS_ADC) {
+    raw_min[0] = ADC_XMIN;
+    raw_max[0] = ADC_XMAX;
+    raw_min[1] = ADC_YMIN;
+    raw_max[1] = ADC_YMAX;
+    rotation += 2;
+  } else {
+    raw_min[0] = TS_MINX;
+    raw_max[0] = TS_MAXX;
+    raw_min[1] = TS_MINY;
+    raw_max[1] = TS_MAXY;
+    // On big TFT FeatherWing, raw X axis is flipped??
+    flip_raw_x = (display->width() == 480) || (display->height() == 480);
+  }
+
+  const uint8_t *r = rotations[rotation & 3];
+  uint8_t x_axis = r[0], y_axis = !r[0];
+  int32_t rows[2][3];
+  calibration_axis(rows[0], x_axis, r[1] ^ (flip_raw_x && !x_axis),
+                   raw_min[x_axis], raw_max[x_axis], display->width());
+  calibration_axis(rows[1], y_axis, r[2] ^ (flip_raw_x && !y_axis),
+                   raw_min[y_axis], raw_max[y_axis], display->height());
+  touch_cal.a = rows[0][0];
+  touch_cal.b = rows[0][1];
+  touch_cal.c = rows[0][2];
+  touch_cal.d = rows[1][0];
+  touch_cal.e = rows[1][1];
+  touch_cal.f = rows[1][2];
+}
+
+// Poll for one raw (uncalibrated) touch sample. Returns true if pressed.
+bool Adafruit_LvGL_Glue::readRawTouch(int32_t *x, int32_t *y) {
+  if (TOUCH_IS_ADC) {
+    TouchScreen *touch = (TouchScreen *)touchscreen;
+    TSPoint p = touch->getPoint();
+    if (p.z < touch->pressureThreshhold) {
+      return false;
+    }
+    *x = p.x;
+    *y = p.y;
+    return true;
+  }
+  Adafruit_STMPE610 *touch = (Adafruit_STMPE610 *)touchscreen;
+  busAcquire(LVGL_BUS_TOUCH); // Shared bus
+  if (!touch->bufferSize()) {
+    return false;
+  }
+  TS_Point p = touch->getPoint();
+  *x = p.x;
+  *y = p.y;
+  return true;
+}
+
+/**
+ * @brief Interactively calibrate the touchscreen: shows three crosshairs in
+ * turn, averages a press on each, and installs the resulting calibration.
+ * Blocks until done. Call after begin(), and use getTouchCalibration() to
+ * save the result (e.g. to EEPROM or a file) for setTouchCalibration() on
+ * later boots.
+ *
+ * @return LvGLStatus The status of the calibration:
+ * * LVGL_OK : Success
+ * * LVGL_ERR_TOUCH : No touchscreen, or the touches didn't make sense
+ * (e.g. all in a line); previous calibration is kept
+ */
+LvGLStatus Adafruit_LvGL_Glue::calibrateTouch(void) {
+  if (!touchscreen) {
+    return LVGL_ERR_TOUCH;
+  }
+  lv_coord_t w = lv_disp_drv.hor_res, h = lv_disp_drv.ver_res;
+  // Targets well apart and not in a line, clear of the bezel edges
+  const lv_point_t screen[3] = {
+      {(lv_coord_t)(w / 10), (lv_coord_t)(h / 10)},
+      {(lv_coord_t)(w * 9 / 10), (lv_coord_t)(h / 2)},
+      {(lv_coord_t)(w / 2), (lv_coord_t)(h * 9 / 10)}};
+  lv_point_t raw[3];
+  int32_t x, y;
+
+#ifdef ESP32
+  lvgl_acquire();
+#endif
+  lv_indev_enable(lv_input_dev_ptr, false); // Keep LittlevGL off the touch
+
+  lv_obj_t *panel = lv_obj_create(lv_disp_get_layer_top(lv_disp));
+  lv_obj_remove_style_all(panel);
+  lv_obj_set_size(panel, w, h);
+  lv_obj_set_style_bg_color(panel, lv_color_black(), 0);
+  lv_obj_set_style_bg_opa(panel, LV_OPA_COVER, 0);
+  lv_obj_t *label = lv_label_create(panel);
+  lv_label_set_text(label, "Touch the crosshair");
+  lv_obj_set_style_text_color(label, lv_color_white(), 0);
+  lv_obj_center(label);
+  lv_obj_t *bars[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    bars[i] = lv_obj_create(panel);
+    lv_obj_remove_style_all(bars[i]);
+    lv_obj_set_size(bars[i], i ? 3 : 21, i ? 21 : 3);
+    lv_obj_set_style_bg_color(bars[i], lv_color_white(), 0);
+    lv_obj_set_style_bg_opa(bars[i], LV_OPA_COVER, 0);
+  }
+
+  for (uint8_t i = 0; i < 3; i++) {
+    lv_obj_set_pos(bars[0], screen[i].x - 10, screen[i].y - 1);
+    lv_obj_set_pos(bars[1], screen[i].x - 1, screen[i].y - 10);
+    lv_refr_now(lv_disp);
+
+    // Average a run of samples from one steady press. If the stylus lifts
+    // partway (~100 ms of no contact), start that press over.
+    int32_t sum_x = 0, sum_y = 0;
+    uint8_t n = 0, misses = 0;
+    while (n < 16) {
+      if (readRawTouch(&x, &y)) {
+        sum_x += x;
+        sum_y += y;
+        n++;
+        misses = 0;
+      } else if (n && (++misses >= 10)) {
+        sum_x = sum_y = n = 0;
+      }
+      delay(10);
+    }
+    raw[i].x = sum_x / n;
+    raw[i].y = sum_y / n;
+
+    for (misses = 0; misses < 10; delay(10)) { // Wait for release
+      misses = readRawTouch(&x, &y) ? 0 : misses + 1;
+    }
+  }
+
+  lv_obj_del(panel);
+  lv_indev_enable(lv_input_dev_ptr, true);
+#ifdef ESP32
+  lvgl_release();
+#endif
+
+  LvGLTouchCalibration cal;
+  if (!computeTouchCalibration(screen, raw, &cal)) {
+    return LVGL_ERR_TOUCH;
+  }
+  setTouchCalibration(&cal);
+  return LVGL_OK;
+}
+
+/**
+ * @brief Compute a touch calibration from three non-collinear screen points
+ * and the raw touch readings taken at them.
+ *
+ * @param screen Three screen positions (pixels)
+ * @param raw Raw touchscreen readings at those positions
+ * @param cal Calibration to fill in
+ * @return true on success, false if the points are (nearly) in a line or
+ * the result is implausibly steep
+ */
+bool Adafruit_LvGL_Glue::computeTouchCalibration(const lv_point_t screen[3],
+                                                 const lv_point_t raw[3],
+                                                 LvGLTouchCalibration *cal) {
+  // Solve screen = M * raw for both screen axes (Cramer's rule). This only
+  // runs once per calibration, so floating point is fine here.
+  double rx0 = raw[0].x - raw[2].x, ry0 = raw[0].y - raw[2].y;
+  double rx1 = raw[1].x - raw[2].x, ry1 = raw[1].y - raw[2].y;
+  double det = rx0 * ry1 - rx1 * ry0;
+  if (fabs(det) < 1.0) {
+    return false;
+  }
+  double m[6];
+  for (uint8_t axis = 0; axis < 2; axis++) {
+    double s0 = axis ? screen[0].y : screen[0].x;
+    double s1 = axis ? screen[1].y : screen[1].x;
+    double s2 = axis ? screen[2].y : screen[2].x;
+    double a = ((s0 - s2) * ry1 - (s1 - s2) * ry0) / det;
+    double b = (rx0 * (s1 - s2) - rx1 * (s0 - s2)) / det;
+    double c = s0 - a * raw[0].x - b * raw[0].y;
+    // More than 4 pixels per raw step, or an offset this far off screen,
+    // means a bad reading rather than a real touchscreen (also keeps the
+    // 16.16 coefficients well inside 32 bits)
+    if ((fabs(a) > 4.0) || (fabs(b) > 4.0) || (fabs(c) > 8192.0)) {
+      return false;
     }
+    m[axis * 3] = a;
+    m[axis * 3 + 1] = b;
+    m[axis * 3 + 2] = c;
+  }
+  cal->a = lround(m[0] * 65536.0);
+  cal->b = lround(m[1] * 65536.0);
+  cal->c = lround(m[2] * 65536.0 + 32768.0); // +0.5 so >> 16 rounds
+  cal->d = lround(m[3] * 65536.0);
+  cal->e = lround(m[4] * 65536.0);
+  cal->f = lround(m[5] * 65536.0 + 32768.0);
+  return true;
+}
+
+/**
+ * @brief Install a touch calibration, e.g. one saved from an earlier
+ * calibrateTouch(). Replaces the built-in default, which otherwise follows
+ * display rotation; a custom calibration is only valid for the rotation it
+ * was made in. May be called before or after begin().
+ *
+ * @param cal Calibration matrix
+ */
+void Adafruit_LvGL_Glue::setTouchCalibration(const LvGLTouchCalibration *cal) {
+  touch_cal = *cal;
+  touch_cal_custom = true;
+}
+
+/**
+ * @brief Get the touch calibration in use, e.g. to save it after
+ * calibrateTouch()
+ *
+ * @param cal Calibration matrix to fill in
+ */
+void Adafruit_LvGL_Glue::getTouchCalibration(LvGLTouchCalibration *cal) const {
+  *cal = touch_cal;
+}
+
+/**
+ * @brief Use the STMPE610's interrupt output instead of polling it over SPI
+ * every input period. While the screen isn't touched, reads then cost no
+ * bus traffic at all (so no display DMA stalls), and input is checked more
+ * often for quicker response. Must be called BEFORE begin(); only one glue
+ * instance at a time can use a touch interrupt.
+ *
+ * @param pin Pin wired to the STMPE610 INT/IRQ output, or -1 to poll
+ * (default). Must be interrupt-capable.
+ */
+void Adafruit_LvGL_Glue::setTouchInterrupt(int8_t pin) { touch_irq_pin = pin; }
+
+/**
+ * @brief Note that the touch controller raised its interrupt. Called from
+ * the pin interrupt handler.
+ */
+void Adafruit_LvGL_Glue::touchInterrupt(void) { touch_irq_flag = true; }
 
-    data->point.x = last_x; // Last-pressed coordinates
-    data->point.y = last_y;
-    data->continue_reading = more;
+/**
+ * @brief Restart touchscreen reads if the STMPE610 interrupt fired while
+ * they were paused (tickless operation). Called before each LittlevGL
+ * timer pass.
+ */
+void Adafruit_LvGL_Glue::touchWake(void) {
+  if (touch_irq_flag && lv_input_dev_ptr) {
+    lv_timer_resume(lv_indev_drv.read_timer);
   }
 }
 
-// OTHER LITTLEVGL VITALS --------------------------------------------------
+/**
+ * @brief Set up filtering of touch samples, to stop jitter from turning
+ * into a stream of tiny drags (and redraws). May be called any time.
+ *
+ * @param filter Filter settings; all zero turns filtering off
+ */
+void Adafruit_LvGL_Glue::setTouchFilter(const LvGLTouchFilter *filter) {
+  touch_filter.configure(filter);
+}
 
-#if LV_COLOR_DEPTH != 16
-#pragma error("LV_COLOR_DEPTH must be 16")
-#endif
-// This isn't necessarily true, don't mention it for now. See notes later.
-// #if LV_COLOR_16_SWAP != 0
-//  #pragma message("Set LV_COLOR_16_SWAP to 0 for best display performance")
-// #endif
+// TOUCH FILTER ------------------------------------------------------------
 
-// Actual RAM usage will be 2X these figures, since using 2 DMA buffers...
-#ifdef _SAMD21_
-#define LV_BUFFER_ROWS 4 // Don't hog all the RAM on SAMD21
-#else
-#define LV_BUFFER_ROWS 8 // Most others have a bit more space
-#endif
+/**
+ * @brief Construct a touch filter that passes samples through unchanged
+ */
+Adafruit_LvGL_TouchFilter::Adafruit_LvGL_TouchFilter(void) {
+  LvGLTouchFilter off = {0, 0, 0};
+  configure(&off);
+}
 
-// This is the flush function required for LittlevGL screen updates.
-// It receives a bounding rect and an array of pixel data (conveniently
-// already in 565 format, so the Earth was lucky there).
-static void lv_flush_callback(lv_disp_drv_t *disp, const lv_area_t *area,
-                              lv_color_t *color_p) {
-  // Get pointer to glue object from indev user data
-  Adafruit_LvGL_Glue *glue = (Adafruit_LvGL_Glue *)disp->user_data;
-  Adafruit_SPITFT *display = glue->display;
+/**
+ * @brief Change filter settings (and start afresh)
+ *
+ * @param filter Filter settings; median windows above
+ * LVGL_TOUCH_MEDIAN_MAX are clipped to it
+ */
+void Adafruit_LvGL_TouchFilter::configure(const LvGLTouchFilter *filter) {
+  config = *filter;
+  if (config.median > LVGL_TOUCH_MEDIAN_MAX) {
+    config.median = LVGL_TOUCH_MEDIAN_MAX;
+  }
+  if (config.smooth > 8) {
+    config.smooth = 8;
+  }
+  reset();
+}
+
+/**
+ * @brief Forget filter history; call when the touch is released so the
+ * next press doesn't drift in from the last one
+ */
+void Adafruit_LvGL_TouchFilter::reset(void) {
+  history_count = history_next = 0;
+  primed = false;
+}
+
+// Median of n (<= LVGL_TOUCH_MEDIAN_MAX) values, by insertion sort
+static lv_coord_t median_of(const lv_coord_t *values, uint8_t n) {
+  lv_coord_t sorted[LVGL_TOUCH_MEDIAN_MAX];
+  for (uint8_t i = 0; i < n; i++) {
+    lv_coord_t v = values[i];
+    uint8_t j = i;
+    for (; j && (sorted[j - 1] > v); j--) {
+      sorted[j] = sorted[j - 1];
+    }
+    sorted[j] = v;
+  }
+  return sorted[n / 2];
+}
+
+// Move the reported coordinate only once the sample leaves the dead zone
+// around it, then let it trail the sample at the zone's edge
+static inline lv_coord_t dead_zone(lv_coord_t out, lv_coord_t in,
+                                   lv_coord_t zone) {
+  if (in > out + zone) {
+    return in - zone;
+  }
+  if (in < out - zone) {
+    return in + zone;
+  }
+  return out;
+}
+
+/**
+ * @brief Filter one pressed sample in place
+ *
+ * @param x Screen X, replaced with the filtered value
+ * @param y Screen Y, replaced with the filtered value
+ */
+void Adafruit_LvGL_TouchFilter::process(lv_coord_t *x, lv_coord_t *y) {
+  if (config.median > 1) {
+    history_x[history_next] = *x;
+    history_y[history_next] = *y;
+    history_next = (history_next + 1) % config.median;
+    history_count += (history_count < config.median);
+    *x = median_of(history_x, history_count);
+    *y = median_of(history_y, history_count);
+  }
+
+  if (config.smooth) {
+    if (primed) {
+      smooth_x += (((int32_t)*x << 4) - smooth_x) >> config.smooth;
+      smooth_y += (((int32_t)*y << 4) - smooth_y) >> config.smooth;
+    } else {
+      smooth_x = (int32_t)*x << 4;
+      smooth_y = (int32_t)*y << 4;
+    }
+    *x = (smooth_x + 8) >> 4;
+    *y = (smooth_y + 8) >> 4;
+  }
 
-  if (!glue->first_frame) {
-    display->dmaWait();  // Wait for prior DMA transfer to complete
-    display->endWrite(); // End transaction from any prior call
+  if (config.dead_zone && primed) {
+    out_x = dead_zone(out_x, *x, config.dead_zone);
+    out_y = dead_zone(out_y, *y, config.dead_zone);
+    *x = out_x;
+    *y = out_y;
   } else {
-    glue->first_frame = false;
+    out_x = *x;
+    out_y = *y;
   }
+  primed = true;
+}
 
-  uint16_t width = (area->x2 - area->x1 + 1);
-  uint16_t height = (area->y2 - area->y1 + 1);
-  display->startWrite();
-  display->setAddrWindow(area->x1, area->y1, width, height);
-  display->writePixels((uint16_t *)color_p, width * height, false,
-                       LV_COLOR_16_SWAP);
-  lv_disp_flush_ready(disp);
+/**
+ * @brief Merge the display's pending invalidated areas wherever one larger
+ * window is cheaper than separate flushes, per setFlushCost(). Called from
+ * LittlevGL's refresh timer just before each refresh.
+ *
+ * @param disp The LittlevGL display about to be refreshed
+ */
+void Adafruit_LvGL_Glue::coalesceAreas(lv_disp_t *disp) {
+  uint16_t n = disp->inv_p;
+  if (!n) {
+    return;
+  }
+  stats.areas_raw += n;
+  frameOpen(micros());
+
+  // Greedy: keep merging the pair with the best saving until none is left.
+  // Overlapping areas count their shared pixels twice, as they would be
+  // sent twice if flushed separately. At most LV_INV_BUF_SIZE areas.
+  while (flush_cost && (n > 1)) {
+    int32_t best_gain = -1;
+    uint16_t best_i = 0, best_j = 0;
+    for (uint16_t i = 0; i < n - 1; i++) {
+      for (uint16_t j = i + 1; j < n; j++) {
+        lv_area_t joined;
+        _lv_area_join(&joined, &disp->inv_areas[i], &disp->inv_areas[j]);
+        int32_t gain = (int32_t)(lv_area_get_size(&disp->inv_areas[i]) +
+                                 lv_area_get_size(&disp->inv_areas[j]) +
+                                 flush_cost) -
+                       (int32_t)lv_area_get_size(&joined);
+        if (gain > best_gain) {
+          best_gain = gain;
+          best_i = i;
+          best_j = j;
+        }
+      }
+    }
+    if (best_gain < 0) {
+      break;
+    }
+    _lv_area_join(&disp->inv_areas[best_i], &disp->inv_areas[best_i],
+                  &disp->inv_areas[best_j]);
+    disp->inv_areas[best_j] = disp->inv_areas[--n];
+  }
+
+  disp->inv_p = n;
+  stats.areas_merged += n;
 }
 
-#if (LV_USE_LOG)
-// Optional LittlevGL debug print function, writes to Serial if debug is
-// enabled when calling glue begin() function.
-static void lv_debug(const char *buf) { Serial.println(buf); }
-#endif
+/**
+ * @brief Byte-swap RGB565 pixels in place, two at a time.
+ *
+ * @param pixels Pixel buffer (any alignment)
+ * @param count Number of pixels
+ */
+void Adafruit_LvGL_Glue::swapBytes(uint16_t *pixels, uint32_t count) {
+  if (((uintptr_t)pixels & 2) && count) { // Get to 32-bit alignment
+    *pixels = __builtin_bswap16(*pixels);
+    pixels++;
+    count--;
+  }
+  swap_word_t *words = (swap_word_t *)pixels;
+  uint32_t n = count / 2;
+  for (; n >= 4; n -= 4, words += 4) { // Unrolled to hide load latency
+    uint32_t w0 = words[0], w1 = words[1], w2 = words[2], w3 = words[3];
+    words[0] = swap_word(w0);
+    words[1] = swap_word(w1);
+    words[2] = swap_word(w2);
+    words[3] = swap_word(w3);
+  }
+  while (n--) {
+    *words = swap_word(*words);
+    words++;
+  }
+  if (count & 1) { // Odd pixel out
+    pixels[count - 1] = __builtin_bswap16(pixels[count - 1]);
+  }
+}
 
-// GLUE LIB FUNCTIONS ------------------------------------------------------
+/**
+ * @brief Choose whether the glue or Adafruit_SPITFT byte-swaps pixels on
+ * their way to this display. Must be called BEFORE begin(). Has no effect
+ * if LV_COLOR_16_SWAP is set in lv_conf.h, since LittlevGL then renders in
+ * display byte order already. With LVGL_BUFFER_DIRECT, the glue only swaps
+ * in PSRAM bounce buffers, never in the kept frame.
+ *
+ * @param policy LVGL_SWAP_AUTO (default: whichever is faster on the board,
+ * LVGL_BOARD_SWAP in Adafruit_LvGL_Glue_Board.h), LVGL_SWAP_GFX or
+ * LVGL_SWAP_GLUE
+ */
+void Adafruit_LvGL_Glue::setSwapPolicy(LvGLSwapPolicy policy) {
+  swap_policy = policy;
+}
+
+/**
+ * @brief Set how expensive one extra flush is compared to sending extra
+ * pixels, which decides how eagerly invalidated areas are merged into
+ * larger windows before each refresh.
+ *
+ * @param pixels Cost of a flush in pixel-equivalents (default 256). 0 leaves
+ * merging entirely to LittlevGL, which only joins areas when no extra
+ * pixels result.
+ */
+void Adafruit_LvGL_Glue::setFlushCost(uint32_t pixels) { flush_cost = pixels; }
+
+/**
+ * @brief Have a function called with every area flushed to the display,
+ * as it's flushed: its position and rendered pixels (LittlevGL's byte
+ * order). Lets screen contents be streamed elsewhere, e.g. to a file,
+ * without a framebuffer. The function may use the SPI bus.
+ *
+ * @param tap Function to call, or NULL to stop
+ * @param user_data Passed through to the function
+ */
+void Adafruit_LvGL_Glue::setFlushTap(LvGLFlushTap tap, void *user_data) {
+  flush_tap = tap;
+  flush_tap_data = user_data;
+}
+
+/**
+ * @brief Total invalidated areas seen before coalescing, since begin() or
+ * the last resetStats()
+ *
+ * @return uint32_t Area count
+ */
+uint32_t Adafruit_LvGL_Glue::getAreasRaw(void) const {
+  return stats.areas_raw;
+}
+
+/**
+ * @brief Total areas left after coalescing (compare to getAreasRaw())
+ *
+ * @return uint32_t Area count
+ */
+uint32_t Adafruit_LvGL_Glue::getAreasMerged(void) const {
+  return stats.areas_merged;
+}
 
 // Constructor
 /**
@@ -272,10 +1766,21 @@ static void lv_debug(const char *buf) { Serial.println(buf); }
  * initializing minimal variables
  *
  */
-Adafruit_LvGL_Glue::Adafruit_LvGL_Glue(void) : first_frame(true) {
-#if defined(ARDUINO_ARCH_SAMD)
-  zerotimer = NULL;
-#endif
+Adafruit_LvGL_Glue::Adafruit_LvGL_Glue(void)
+    : lv_pixel_buf(NULL), lv_bounce_buf(NULL), lv_disp(NULL),
+      lv_input_dev_ptr(NULL), memory_policy(LVGL_MEMORY_AUTO),
+      bounce_amount(0), bounce_pixels(0),
+      buffer_mode(LVGL_BUFFER_DEFAULT), buffer_amount(0), buffer_pixels(0),
+      buffer_count(0), swap_policy(LVGL_SWAP_AUTO),
+      flush_cost(LV_FLUSH_COST_DEFAULT), flush_pending(false),
+      flush_last(false), write_open(false), swap_pixels(false),
+      bus_chunk(LV_BUS_CHUNK_DEFAULT), chunk_left(0), chunk_stride(0),
+      direct_next(0), flush_tap(NULL), flush_tap_data(NULL),
+      frame_open(false), frame_start(0), wait_start(0), touch_cal_custom(false),
+      touch_cal_rotation(0), touch_irq_pin(-1), touch_irq_flag(false),
+      touch_active(false), touch_x(0), touch_y(0), touch_release_count(0),
+      suspended(false) {
+  resetStats();
 }
 
 // Destructor
@@ -284,12 +1789,211 @@ Adafruit_LvGL_Glue::Adafruit_LvGL_Glue(void) : first_frame(true) {
  * memory previously allocated within this library.
  *
  */
-Adafruit_LvGL_Glue::~Adafruit_LvGL_Glue(void) {
-  delete[] lv_pixel_buf;
-#if defined(ARDUINO_ARCH_SAMD)
-  delete zerotimer;
+Adafruit_LvGL_Glue::~Adafruit_LvGL_Glue(void) { end(); }
+
+/**
+ * @brief Choose where draw buffers are allocated. Only matters on ESP32
+ * boards with PSRAM; elsewhere there's just the one heap. Must be called
+ * BEFORE begin().
+ *
+ * @param policy Placement:
+ * * LVGL_MEMORY_AUTO : Internal DMA-capable RAM if the buffers fit, else
+ *   PSRAM (the default)
+ * * LVGL_MEMORY_INTERNAL : Internal DMA-capable RAM only
+ * * LVGL_MEMORY_PSRAM : PSRAM, for large or full-screen buffers
+ * @param bounce_pixels Size of the internal buffer(s) PSRAM draw buffers
+ * are sent through, in pixels; 0 for a few rows
+ */
+void Adafruit_LvGL_Glue::setMemoryPolicy(LvGLMemoryPolicy policy,
+                                         uint32_t bounce_pixels) {
+  memory_policy = policy;
+  bounce_amount = bounce_pixels;
+}
+
+/**
+ * @brief Check whether the draw buffers ended up in PSRAM (and are sent
+ * through a bounce buffer), see setMemoryPolicy()
+ *
+ * @return true if in PSRAM
+ */
+bool Adafruit_LvGL_Glue::getBufferExternal(void) const {
+  return lv_bounce_buf != NULL;
+}
+
+/**
+ * @brief Get the LittlevGL display this glue drives. With more than one
+ * display, use this to create screens on (or make default) a specific one.
+ *
+ * @return lv_disp_t* The display, or NULL before a successful begin()
+ */
+lv_disp_t *Adafruit_LvGL_Glue::getDisplay(void) const { return lv_disp; }
+
+/**
+ * @brief Check whether the display is asleep, see suspend()
+ *
+ * @return true if suspended
+ */
+bool Adafruit_LvGL_Glue::isSuspended(void) const { return suspended; }
+
+/**
+ * @brief Choose how large LittlevGL's draw buffer(s) should be. Larger
+ * buffers mean fewer flush calls (and fewer address window commands and DMA
+ * setups) per frame, at the cost of RAM. Must be called BEFORE begin().
+ *
+ * @param mode How to size the buffer:
+ * * LVGL_BUFFER_DEFAULT : A few rows, depending on the board (the default)
+ * * LVGL_BUFFER_ROWS : `amount` full-width rows
+ * * LVGL_BUFFER_BYTES : At most `amount` bytes per buffer, rounded down to
+ *   whole rows
+ * * LVGL_BUFFER_FULL : The whole screen
+ * * LVGL_BUFFER_AUTO : A share of the free heap, backing off toward the
+ *   default size if allocation fails
+ * * LVGL_BUFFER_DIRECT : One whole-screen buffer, kept from frame to
+ *   frame. LittlevGL redraws only the changed areas, in place, and only
+ *   those are sent. Unchanged objects around them aren't redrawn strip by
+ *   strip as with smaller buffers. Suits boards with RAM to spare (SAMD51,
+ *   ESP32 with PSRAM).
+ * @param amount Rows or bytes, depending on mode; ignored otherwise
+ * @note If two DMA buffers won't fit, begin() falls back on a single buffer
+ * of the same size. Use getBufferPixels() and getBufferCount() to see what
+ * was actually allocated.
+ */
+void Adafruit_LvGL_Glue::setBufferSize(LvGLBufferMode mode, uint32_t amount) {
+  buffer_mode = mode;
+  buffer_amount = amount;
+}
+
+/**
+ * @brief Size of each draw buffer chosen by begin()
+ *
+ * @return uint32_t Pixels per buffer, or 0 if begin() hasn't succeeded
+ */
+uint32_t Adafruit_LvGL_Glue::getBufferPixels(void) const {
+  return buffer_pixels;
+}
+
+/**
+ * @brief Height of each draw buffer chosen by begin()
+ *
+ * @return uint16_t Full-width rows per buffer, or 0 if begin() hasn't
+ * succeeded
+ */
+uint16_t Adafruit_LvGL_Glue::getBufferRows(void) const {
+  return buffer_pixels ? buffer_pixels / lv_disp_drv.hor_res : 0;
+}
+
+/**
+ * @brief Number of draw buffers allocated by begin()
+ *
+ * @return uint8_t 2 if double-buffering (DMA), 1 if not, 0 if begin() hasn't
+ * succeeded
+ */
+uint8_t Adafruit_LvGL_Glue::getBufferCount(void) const { return buffer_count; }
+
+// Allocate draw buffer(s) per buffer_mode/buffer_amount, setting
+// lv_pixel_buf, buffer_pixels and buffer_count. Returns false on failure.
+bool Adafruit_LvGL_Glue::allocBuffers(lv_coord_t hor_res, lv_coord_t ver_res) {
+#if defined(USE_SPI_DMA)
+  // Double buffering only helps with DMA, and direct mode has one frame
+  const uint8_t max_count =
+      (LVGL_BOARD_DIRECT && (buffer_mode == LVGL_BUFFER_DIRECT)) ? 1 : 2;
+#else
+  const uint8_t max_count = 1;
 #endif
-  // Probably other stuff that could be deallocated here
+  uint32_t full = (uint32_t)hor_res * ver_res;
+  uint32_t pixels;
+  bool external = (memory_policy == LVGL_MEMORY_PSRAM) && lvgl_has_psram();
+
+  switch (buffer_mode) {
+  case LVGL_BUFFER_ROWS:
+    pixels = buffer_amount * hor_res;
+    break;
+  case LVGL_BUFFER_BYTES:
+    pixels = buffer_amount / sizeof(lv_color_t);
+    break;
+  case LVGL_BUFFER_FULL:
+  case LVGL_BUFFER_DIRECT:
+    pixels = full;
+    break;
+  case LVGL_BUFFER_AUTO:
+    pixels = lvgl_free_heap(external) / LV_BUFFER_AUTO_DIVISOR / max_count /
+             sizeof(lv_color_t);
+    break;
+  default:
+    pixels = LV_BUFFER_ROWS * hor_res;
+    break;
+  }
+  // Whole rows only, at least one and no more than a full screen
+  pixels -= pixels % hor_res;
+  if (pixels < (uint32_t)hor_res) {
+    pixels = hor_res;
+  } else if (pixels > full) {
+    pixels = full;
+  }
+
+  uint8_t count = max_count;
+  while (!(lv_pixel_buf = (lv_color_t *)lvgl_buf_alloc(
+               pixels * count * sizeof(lv_color_t), external))) {
+    if (count > 1) {
+      count = 1; // Try single-buffered before giving up on this size
+    } else if (!external && (memory_policy == LVGL_MEMORY_AUTO) &&
+               lvgl_has_psram()) {
+      external = true; // Same size in PSRAM, before settling for less
+      count = max_count;
+    } else if ((buffer_mode == LVGL_BUFFER_AUTO) &&
+               (pixels > (uint32_t)LV_BUFFER_ROWS * hor_res)) {
+      pixels = (pixels / 2) - ((pixels / 2) % hor_res);
+      if (pixels < (uint32_t)LV_BUFFER_ROWS * hor_res) {
+        pixels = LV_BUFFER_ROWS * hor_res;
+      }
+      count = max_count;
+    } else {
+      buffer_pixels = buffer_count = 0;
+      return false;
+    }
+  }
+
+  // SPI DMA can't read PSRAM (or only slowly), so PSRAM draw buffers are
+  // sent through small internal ones
+  if (external) {
+    bounce_pixels = bounce_amount ? bounce_amount : LV_BOUNCE_ROWS * hor_res;
+    if (bounce_pixels > pixels) {
+      bounce_pixels = pixels;
+    }
+    if (!(lv_bounce_buf = (uint16_t *)lvgl_buf_alloc(
+              bounce_pixels * max_count * sizeof(uint16_t), false))) {
+      freeBuffers();
+      return false;
+    }
+  }
+
+  buffer_pixels = pixels;
+  buffer_count = count;
+  return true;
+}
+
+// Release draw and bounce buffers
+void Adafruit_LvGL_Glue::freeBuffers(void) {
+  free(lv_pixel_buf);
+  lv_pixel_buf = NULL;
+  free(lv_bounce_buf);
+  lv_bounce_buf = NULL;
+  buffer_pixels = bounce_pixels = 0;
+  buffer_count = 0;
+}
+
+// Free the draw buffers while suspended, leaving LittlevGL a single row to
+// draw into. Another display's refresh timer or an lv_refr_now() can still
+// refresh this one, and flush() drops what it draws. A NULL, zero-size
+// buffer would make LittlevGL's refresh loop forever instead (no rows fit),
+// and direct mode would draw whole-screen offsets into the row.
+void Adafruit_LvGL_Glue::parkBuffers(void) {
+  freeBuffers();
+  lv_disp_drv.direct_mode = false;
+  lv_coord_t width = lv_disp_drv.hor_res;
+  lv_pixel_buf = (lv_color_t *)malloc(width * sizeof(lv_color_t));
+  lv_disp_draw_buf_init(&lv_disp_draw_buf, lv_pixel_buf, NULL,
+                        lv_pixel_buf ? width : 0);
 }
 
 // begin() function is overloaded for STMPE610 touch, ADC touch, or none.
@@ -314,9 +2018,13 @@ Adafruit_LvGL_Glue::~Adafruit_LvGL_Glue(void) {
  * * LVGL_OK : Success
  * * LVGL_ERR_TIMER : Failure to set up timers
  * * LVGL_ERR_ALLOC : Failure to allocate memory
+ * * LVGL_ERR_TOUCH : Board profile only supports ADC touchscreens
  */
 LvGLStatus Adafruit_LvGL_Glue::begin(Adafruit_SPITFT *tft,
                                      Adafruit_STMPE610 *touch, bool debug) {
+  if (LVGL_BOARD_TOUCH == LVGL_BOARD_TOUCH_ADC) {
+    return LVGL_ERR_TOUCH; // Board profile leaves out STMPE610 reads
+  }
   is_adc_touch = false;
   return begin(tft, (void *)touch, debug);
 }
@@ -333,9 +2041,13 @@ LvGLStatus Adafruit_LvGL_Glue::begin(Adafruit_SPITFT *tft,
  * * LVGL_OK : Success
  * * LVGL_ERR_TIMER : Failure to set up timers
  * * LVGL_ERR_ALLOC : Failure to allocate memory
+ * * LVGL_ERR_TOUCH : Board profile only supports STMPE610 touchscreens
  */
 LvGLStatus Adafruit_LvGL_Glue::begin(Adafruit_SPITFT *tft, TouchScreen *touch,
                                      bool debug) {
+  if (LVGL_BOARD_TOUCH == LVGL_BOARD_TOUCH_STMPE610) {
+    return LVGL_ERR_TOUCH; // Board profile leaves out ADC reads
+  }
   is_adc_touch = true;
   return begin(tft, (void *)touch, debug);
 }
@@ -358,51 +2070,67 @@ LvGLStatus Adafruit_LvGL_Glue::begin(Adafruit_SPITFT *tft, bool debug) {
 LvGLStatus Adafruit_LvGL_Glue::begin(Adafruit_SPITFT *tft, void *touch,
                                      bool debug) {
 
-  lv_init();
+  if (!lvgl_initialized) { // First display
+    lv_init();
+    lvgl_initialized = true;
+  }
+#ifdef ESP32
+  bool locked = (xGuiSemaphore != NULL); // Another display already running
+  if (locked) {
+    lvgl_acquire();
+  }
+#endif
 #if (LV_USE_LOG)
   if (debug) {
     lv_log_register_print_cb(lv_debug); // Register debug print function
   }
 #endif
 
-  // Allocate LvGL display buffer (x2 because DMA double buffering)
+  // Boards whose display driver misreports the screen size (ST7789 on CLUE
+  // and TFT Gizmo) set it in their profile, others ask the display
+  lv_coord_t hor_res = LVGL_BOARD_HOR_RES ? LVGL_BOARD_HOR_RES : tft->width();
+  lv_coord_t ver_res =
+      LVGL_BOARD_VER_RES ? LVGL_BOARD_VER_RES : tft->height();
+
+  resetStats();
+
+  // Allocate LvGL display buffer(s), sized per setBufferSize()
   LvGLStatus status = LVGL_ERR_ALLOC;
-#if defined(USE_SPI_DMA)
-  if ((lv_pixel_buf = new lv_color_t[tft->width() * LV_BUFFER_ROWS * 2])) {
-#else
-  if ((lv_pixel_buf = new lv_color_t[tft->width() * LV_BUFFER_ROWS])) {
-#endif
+  if (allocBuffers(hor_res, ver_res)) {
 
     display = tft;
     touchscreen = (void *)touch;
+    LvGLSwapPolicy swap =
+        (swap_policy == LVGL_SWAP_AUTO) ? (LvGLSwapPolicy)LVGL_BOARD_SWAP
+                                        : swap_policy;
+    swap_pixels = !LV_COLOR_16_SWAP && (swap == LVGL_SWAP_GLUE);
+    if (touch && !touch_cal_custom) {
+      defaultTouchCalibration();
+    }
 
-    // Initialize LvGL display buffers. The "second half" buffer is only
-    // used if USE_SPI_DMA is enabled in Adafruit_GFX.
-    lv_disp_draw_buf_init(&lv_disp_draw_buf, lv_pixel_buf,
-#if defined(USE_SPI_DMA)
-                          &lv_pixel_buf[tft->width() * LV_BUFFER_ROWS],
-#else
-                          NULL, // No double-buffering
-#endif
-                          tft->width() * LV_BUFFER_ROWS);
+    // Initialize LvGL display buffers. The second buffer is only
+    // allocated if USE_SPI_DMA is enabled in Adafruit_GFX (and fits).
+    lv_disp_draw_buf_init(
+        &lv_disp_draw_buf, lv_pixel_buf,
+        (buffer_count > 1) ? &lv_pixel_buf[buffer_pixels] : NULL,
+        buffer_pixels);
 
     // Initialize LvGL display driver
     lv_disp_drv_init(&lv_disp_drv);
-#if defined(ARDUINO_NRF52840_CLUE) || defined(ARDUINO_NRF52840_CIRCUITPLAY) || \
-    defined(ARDUINO_SAMD_CIRCUITPLAYGROUND_EXPRESS)
-    // ST7789 library (used by CLUE and TFT Gizmo for Circuit Playground
-    // Express/Bluefruit) is sort of low-level rigged to a 240x320
-    // screen, so this needs to work around that manually...
-    lv_disp_drv.hor_res = 240;
-    lv_disp_drv.ver_res = 240;
-#else
-    lv_disp_drv.hor_res = tft->width();
-    lv_disp_drv.ver_res = tft->height();
-#endif
+    lv_disp_drv.hor_res = hor_res;
+    lv_disp_drv.ver_res = ver_res;
     lv_disp_drv.flush_cb = lv_flush_callback;
+    lv_disp_drv.wait_cb = lv_wait_callback;
+    lv_disp_drv.gpu_wait_cb = lv_gpu_wait_callback;
     lv_disp_drv.draw_buf = &lv_disp_draw_buf;
+    lv_disp_drv.direct_mode =
+        LVGL_BOARD_DIRECT && (buffer_mode == LVGL_BUFFER_DIRECT);
     lv_disp_drv.user_data = this;
-    lv_disp_drv_register(&lv_disp_drv);
+    lv_disp = lv_disp_drv_register(&lv_disp_drv);
+    lv_timer_set_cb(lv_disp->refr_timer, lv_refr_timer_callback);
+#if LV_TICK_CUSTOM
+    lv_disp_drv.rounder_cb = lv_rounder_callback; // Once lv_disp is known
+#endif
 
     // Initialize LvGL input device (touchscreen already started)
     if ((touch)) { // Can also pass NULL if passive widget display
@@ -410,123 +2138,206 @@ LvGLStatus Adafruit_LvGL_Glue::begin(Adafruit_SPITFT *tft, void *touch,
       lv_indev_drv.type = LV_INDEV_TYPE_POINTER; // Is pointer dev
       lv_indev_drv.read_cb = touchscreen_read;   // Read callback
       lv_indev_drv.user_data = this;
+      lv_indev_drv.disp = lv_disp; // Not necessarily the default display
       lv_input_dev_ptr = lv_indev_drv_register(&lv_indev_drv);
-    }
 
-    // TIMER SETUP is architecture-specific ----------------------------
-
-#if defined(ARDUINO_ARCH_SAMD) // --------------------------------------
-
-    // status is still ERR_ALLOC until proven otherwise...
-    if ((zerotimer = new Adafruit_ZeroTimer(TIMER_NUM))) {
-      uint16_t divider = 1;
-      uint16_t compare = 0;
-      tc_clock_prescaler prescaler = TC_CLOCK_PRESCALER_DIV1;
-
-      status = LVGL_OK; // We're prob good now, but one more test...
-
-      int freq = 1000 / lv_tick_interval_ms;
-
-      if ((freq < (48000000 / 2)) && (freq > (48000000 / 65536))) {
-        divider = 1;
-        prescaler = TC_CLOCK_PRESCALER_DIV1;
-      } else if (freq > (48000000 / 65536 / 2)) {
-        divider = 2;
-        prescaler = TC_CLOCK_PRESCALER_DIV2;
-      } else if (freq > (48000000 / 65536 / 4)) {
-        divider = 4;
-        prescaler = TC_CLOCK_PRESCALER_DIV4;
-      } else if (freq > (48000000 / 65536 / 8)) {
-        divider = 8;
-        prescaler = TC_CLOCK_PRESCALER_DIV8;
-      } else if (freq > (48000000 / 65536 / 16)) {
-        divider = 16;
-        prescaler = TC_CLOCK_PRESCALER_DIV16;
-      } else if (freq > (48000000 / 65536 / 64)) {
-        divider = 64;
-        prescaler = TC_CLOCK_PRESCALER_DIV64;
-      } else if (freq > (48000000 / 65536 / 256)) {
-        divider = 256;
-        prescaler = TC_CLOCK_PRESCALER_DIV256;
+      uint8_t slot = 0;
+      while ((slot < TOUCH_IRQ_SLOTS) && touch_irq_glue[slot] &&
+             (touch_irq_glue[slot] != this)) {
+        slot++;
+      }
+      if (!TOUCH_IS_ADC && (touch_irq_pin >= 0) && (slot < TOUCH_IRQ_SLOTS)) {
+        // Active-low level interrupt on touch detect (open-drain friendly),
+        // cleared by writing INT_STA after each FIFO read
+        Adafruit_STMPE610 *ts = (Adafruit_STMPE610 *)touch;
+        ts->writeRegister8(STMPE_INT_EN, STMPE_INT_EN_TOUCHDET);
+        ts->writeRegister8(STMPE_INT_STA, 0xFF);
+        ts->writeRegister8(STMPE_INT_CTRL,
+                           STMPE_INT_CTRL_POL_LOW | STMPE_INT_CTRL_ENABLE);
+        touch_irq_flag = true; // Read once, in case already touched
+        touch_irq_glue[slot] = this;
+        pinMode(touch_irq_pin, INPUT_PULLUP);
+        attachInterrupt(digitalPinToInterrupt(touch_irq_pin), touch_isr[slot],
+                        FALLING);
+        lv_timer_set_period(lv_indev_drv.read_timer, TOUCH_IRQ_READ_PERIOD);
       } else {
-        status = LVGL_ERR_TIMER; // Invalid frequency
+        touch_irq_pin = -1; // Poll instead
       }
+    }
 
-      if (status == LVGL_OK) {
-        compare = (48000000 / divider) / freq;
-        // Initialize timer
-        zerotimer->configure(prescaler, TC_COUNTER_SIZE_16BIT,
-                             TC_WAVE_GENERATION_MATCH_PWM);
-        zerotimer->setCompare(0, compare);
-        zerotimer->setCallback(true, TC_CALLBACK_CC_CHANNEL0, timerCallback0);
-        zerotimer->enable(true);
+    // LittlevGL's tick is shared by all displays, started by the first
+    if (!lvgl_tick_running) {
+      status = lvgl_tick_begin();
+      lvgl_tick_running = (status == LVGL_OK);
+    } else {
+      if (!lvgl_awake) { // Others all suspended or ended
+        lvgl_tick_enable(true);
       }
+      status = LVGL_OK;
     }
+    if (status == LVGL_OK) {
+      lvgl_awake++;
+    }
+  }
 
-#elif defined(ESP32) // ------------------------------------------------
-    // Create a periodic timer to call `lv_tick_handler`
-    const esp_timer_create_args_t periodic_timer_args = {
-        .callback = &lv_tick_handler, .name = "lv_tick_handler"};
-    esp_timer_handle_t periodic_timer;
-    ESP_ERROR_CHECK(esp_timer_create(&periodic_timer_args, &periodic_timer));
-
-    // Create a new mutex
-    xGuiSemaphore = xSemaphoreCreateMutex();
-    if (xGuiSemaphore == NULL) {
-      return LVGL_ERR_MUTEX; // failure
-    }
-
-    // Pin the LVGL gui task to core 1
-    // TODO: For ESP32-S2/C3, this will need to be pined to core 0
-
-#ifdef CONFIG_IDF_TARGET_ESP32C3
-    // For unicore ESP32-x, pin GUI task to core 0
-    if (xTaskCreatePinnedToCore(gui_task, "lvgl_gui", 1024 * 8, NULL, 5,
-                                &g_lvgl_task_handle, 0) != pdPASS)
-      return LVGL_ERR_TASK; // failure
-#else
-    // For multicore ESP32-x, pin GUI task to core 1 to allow WiFi on core 0
-    if (xTaskCreatePinnedToCore(gui_task, "lvgl_gui", 1024 * 8, NULL, 5,
-                                &g_lvgl_task_handle, 1) != pdPASS)
-      return LVGL_ERR_TASK; // failure
-#endif
-
-    // Start timer
-    ESP_ERROR_CHECK(
-        esp_timer_start_periodic(periodic_timer, lv_tick_interval_ms * 1000));
-    status = LVGL_OK;
-
-#elif defined(NRF52_SERIES) // -----------------------------------------
-
-  TIMER_ID->TASKS_STOP = 1;               // Stop timer
-  TIMER_ID->MODE = TIMER_MODE_MODE_Timer; // Not counter mode
-  TIMER_ID->TASKS_CLEAR = 1;
-  TIMER_ID->BITMODE = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
-  TIMER_ID->PRESCALER = 0; // 1:1 prescale (16 MHz)
-  TIMER_ID->INTENSET = TIMER_INTENSET_COMPARE0_Enabled
-                       << TIMER_INTENSET_COMPARE0_Pos; // Event 0 int
-  TIMER_ID->CC[0] = TIMER_FREQ / (lv_tick_interval_ms * 1000);
-
-  NVIC_DisableIRQ(TIMER_IRQN);
-  NVIC_ClearPendingIRQ(TIMER_IRQN);
-  NVIC_SetPriority(TIMER_IRQN, 2); // Lower priority than soft device
-  NVIC_EnableIRQ(TIMER_IRQN);
+  if (status != LVGL_OK) {
+    removeDisplay();
+    freeBuffers();
+  }
 
-  TIMER_ID->TASKS_START = 1; // Start timer
+#ifdef ESP32
+  if (locked) {
+    lvgl_release();
+  }
+#endif
+  return status;
+}
 
-  status = LVGL_OK;
+/**
+ * @brief Shut down this display: remove it (and its screens) and its
+ * touchscreen from LittlevGL and free its draw buffers. LittlevGL itself
+ * stays initialized, so begin() may be called again later; the tick timer
+ * (and ESP32 GUI task) stop once no display is left running. Called by the
+ * destructor.
+ */
+void Adafruit_LvGL_Glue::end(void) {
+  if (!lv_disp) {
+    return; // Never begun, or already ended
+  }
+#ifdef ESP32
+  lvgl_acquire();
+#endif
+  flushWait();
+  removeDisplay();
+  if (!suspended && !--lvgl_awake) {
+    lvgl_tick_enable(false);
+  }
+  suspended = false;
+#ifdef ESP32
+  lvgl_release();
+#endif
+  freeBuffers();
+}
 
-#endif // end timer setup --------------------------------------------------
+// Take this display and its touchscreen back out of LittlevGL
+void Adafruit_LvGL_Glue::removeDisplay(void) {
+  if (lv_input_dev_ptr) {
+    if (touch_irq_pin >= 0) {
+      detachInterrupt(digitalPinToInterrupt(touch_irq_pin));
+      for (uint8_t slot = 0; slot < TOUCH_IRQ_SLOTS; slot++) {
+        if (touch_irq_glue[slot] == this) {
+          touch_irq_glue[slot] = NULL;
+        }
+      }
+    }
+    lv_indev_delete(lv_input_dev_ptr);
+    lv_input_dev_ptr = NULL;
   }
+  if (lv_disp) {
+    lv_disp_remove(lv_disp);
+    lv_disp = NULL;
+  }
+}
 
-  if (status != LVGL_OK) {
-    delete[] lv_pixel_buf;
-    lv_pixel_buf = NULL;
-#if defined(ARDUINO_ARCH_SAMD)
-    delete zerotimer;
-    zerotimer = NULL;
+/**
+ * @brief Put this display to sleep, e.g. before the MCU enters a low-power
+ * mode: finishes any transfer, then stops refreshing the display and
+ * reading its touchscreen. Once every display is suspended, the tick timer
+ * (and ESP32 GUI task) stop too, so nothing wakes the MCU. Widgets are
+ * untouched, and may still be changed while suspended.
+ *
+ * @param release_buffers If true, also free the draw buffers until resume()
+ * (all but one row, which LittlevGL draws into and the glue discards)
+ * @note On ESP32, don't call this from LittlevGL callbacks (the GUI task
+ * can't suspend itself there, and would keep running until resume()).
+ */
+void Adafruit_LvGL_Glue::suspend(bool release_buffers) {
+  if (!lv_disp) {
+    return;
+  }
+#ifdef ESP32
+  lvgl_acquire();
 #endif
+  flushWait();
+  if (!suspended) {
+    suspended = true;
+    if (lv_input_dev_ptr) {
+      lv_indev_enable(lv_input_dev_ptr, false);
+    }
+    if (!--lvgl_awake) {
+      lvgl_tick_enable(false);
+    }
   }
+  if (release_buffers && buffer_count) {
+    parkBuffers();
+  }
+#ifdef ESP32
+  lvgl_release();
+#endif
+}
 
+/**
+ * @brief Wake this display after suspend(): reallocates draw buffers if
+ * they were released, restarts the tick timer if needed and redraws the
+ * whole screen (the panel may have lost its contents while asleep).
+ *
+ * @return LvGLStatus The status of the wakeup:
+ * * LVGL_OK : Success (or not suspended)
+ * * LVGL_ERR_ALLOC : Draw buffers couldn't be reallocated, still suspended
+ */
+LvGLStatus Adafruit_LvGL_Glue::resume(void) {
+  if (!lv_disp || !suspended) {
+    return LVGL_OK;
+  }
+  LvGLStatus status = LVGL_OK;
+#ifdef ESP32
+  lvgl_acquire();
+#endif
+  if (!buffer_count) { // Parked by suspend(true)
+    // Heap may have changed while asleep, buffers are re-sized the same way
+    freeBuffers();
+    if (allocBuffers(lv_disp_drv.hor_res, lv_disp_drv.ver_res)) {
+      lv_disp_draw_buf_init(
+          &lv_disp_draw_buf, lv_pixel_buf,
+          (buffer_count > 1) ? &lv_pixel_buf[buffer_pixels] : NULL,
+          buffer_pixels);
+      lv_disp_drv.direct_mode =
+          LVGL_BOARD_DIRECT && (buffer_mode == LVGL_BUFFER_DIRECT);
+    } else {
+      parkBuffers();
+      status = LVGL_ERR_ALLOC;
+    }
+  }
+  if (status == LVGL_OK) {
+    suspended = false;
+    if (!lvgl_awake++) {
+      lvgl_tick_enable(true);
+    }
+    if (lv_input_dev_ptr) {
+      lv_indev_enable(lv_input_dev_ptr, true);
+    }
+    lv_obj_invalidate(lv_disp_get_scr_act(lv_disp));
+    resetStats(); // Don't count the sleep as one long frame
+  }
+#ifdef ESP32
+  lvgl_release();
+#endif
   return status;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Run LittlevGL: call this from loop() in place of lv_task_handler()
+ * (not on ESP32, where the GUI task does it). With LV_TICK_CUSTOM set in
+ * lv_conf.h ("tickless" operation, no timer interrupt), it then also
+ * sleeps until LittlevGL's next timer is due or a touch interrupt arrives,
+ * so a static screen costs next to no CPU time.
+ *
+ * @return uint32_t Milliseconds until LittlevGL next needs to run
+ */
+uint32_t Adafruit_LvGL_Glue::service(void) {
+  uint32_t ms = lvgl_timer_pass();
+#if LV_TICK_CUSTOM && !defined(ESP32)
+  lvgl_idle(ms);
+#endif
+  return ms;
+}
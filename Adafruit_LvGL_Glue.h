@@ -10,15 +10,156 @@
 #elif defined(ESP32)
 #include <Ticker.h> // ESP32-specific timer lib
 #endif
+#include "Adafruit_LvGL_Glue_Board.h" // Settings for the board in use
 
 typedef enum {
   LVGL_OK,
   LVGL_ERR_ALLOC,
   LVGL_ERR_TIMER,
   LVGL_ERR_MUTEX,
-  LVGL_ERR_TASK
+  LVGL_ERR_TASK,
+  LVGL_ERR_TOUCH
 } LvGLStatus;
 
+/**
+ * @brief Draw buffer sizing modes, see Adafruit_LvGL_Glue::setBufferSize()
+ */
+typedef enum {
+  LVGL_BUFFER_DEFAULT, ///< Board-dependent default of a few rows
+  LVGL_BUFFER_ROWS,    ///< A given number of full-width rows
+  LVGL_BUFFER_BYTES,   ///< A given number of bytes (per buffer)
+  LVGL_BUFFER_FULL,    ///< A whole screen
+  LVGL_BUFFER_AUTO,    ///< As large as free heap comfortably allows
+  LVGL_BUFFER_DIRECT   ///< A whole screen, kept from frame to frame
+} LvGLBufferMode;
+
+/**
+ * @brief Where draw buffers are allocated (ESP32 with PSRAM), see
+ * Adafruit_LvGL_Glue::setMemoryPolicy()
+ */
+typedef enum {
+  LVGL_MEMORY_AUTO,     ///< Internal DMA-capable RAM, else PSRAM if too big
+  LVGL_MEMORY_INTERNAL, ///< Internal DMA-capable RAM only
+  LVGL_MEMORY_PSRAM     ///< PSRAM, sent via an internal bounce buffer
+} LvGLMemoryPolicy;
+
+/**
+ * @brief Who byte-swaps RGB565 pixels for the display, see
+ * Adafruit_LvGL_Glue::setSwapPolicy()
+ */
+typedef enum {
+  LVGL_SWAP_AUTO, ///< Per board, LVGL_BOARD_SWAP (GFX on ESP32, else GLUE)
+  LVGL_SWAP_GFX,  ///< Adafruit_SPITFT::writePixels() swaps as it sends
+  LVGL_SWAP_GLUE  ///< The glue swaps the draw buffer in place first
+} LvGLSwapPolicy;
+
+/**
+ * @brief Devices sharing the display's SPI bus, see
+ * Adafruit_LvGL_Glue::busAcquire()
+ */
+typedef enum {
+  LVGL_BUS_NONE,    ///< Nobody (bus idle)
+  LVGL_BUS_DISPLAY, ///< Display transfers
+  LVGL_BUS_TOUCH,   ///< STMPE610 touchscreen
+  LVGL_BUS_SD,      ///< SD card (Adafruit_LvGL_Glue_SD)
+  LVGL_BUS_CLIENTS  ///< Number of bus devices
+} LvGLBusClient;
+
+/**
+ * @brief Display pipeline statistics, see Adafruit_LvGL_Glue::getStats()
+ */
+typedef struct {
+  uint32_t frames;       ///< Display refreshes completed
+  uint32_t flushes;      ///< Areas sent (flush callbacks); /frames for avg
+  uint32_t pixels;       ///< Pixels sent
+  uint32_t bytes;        ///< Pixel data bytes sent
+  uint32_t areas_raw;    ///< Invalidated areas before coalescing
+  uint32_t areas_merged; ///< Areas left after coalescing
+  uint32_t dma_wait_us;  ///< Time blocked waiting on display transfers
+  uint32_t render_us;    ///< LittlevGL render time between flushes
+  uint32_t flush_us;     ///< Time inside the flush callback itself
+  uint32_t frame_us_min; ///< Shortest refresh, start to last pixel sent
+  uint32_t frame_us_avg; ///< Mean refresh time
+  uint32_t frame_us_max; ///< Longest refresh
+  uint32_t bus_yields;   ///< Transfers paused mid-area for touch or SD
+  uint32_t bus_wait_us;  ///< Time touch or SD waited on the display's bus
+} LvGLStats;
+
+/**
+ * @brief Touchscreen calibration: a 2x3 affine matrix in 16.16 fixed point
+ * mapping raw touch readings to screen pixels, see
+ * Adafruit_LvGL_Glue::setTouchCalibration()
+ */
+typedef struct {
+  int32_t a; ///< Screen X = (a * raw X + b * raw Y + c) >> 16
+  int32_t b; ///< Raw Y weight for screen X
+  int32_t c; ///< Screen X offset
+  int32_t d; ///< Screen Y = (d * raw X + e * raw Y + f) >> 16
+  int32_t e; ///< Raw Y weight for screen Y
+  int32_t f; ///< Screen Y offset
+} LvGLTouchCalibration;
+
+/**
+ * @brief Called with each area as it's flushed to the display, see
+ * Adafruit_LvGL_Glue::setFlushTap()
+ */
+typedef void (*LvGLFlushTap)(const lv_area_t *area, const lv_color_t *pixels,
+                             void *user_data);
+
+#ifdef ESP32
+/**
+ * @brief ESP32 GUI task settings, see Adafruit_LvGL_Glue::setTaskConfig()
+ */
+typedef struct {
+  uint32_t stack_size;  ///< Stack size in bytes (default 8K)
+  uint8_t priority;     ///< FreeRTOS priority (default 5)
+  int8_t core;          ///< Core to pin to, or -1 for either (default 1)
+  uint16_t queue_depth; ///< post() queue length, 0 for none (default 16)
+} LvGLTaskConfig;
+
+/**
+ * @brief UI update run by the GUI task, see Adafruit_LvGL_Glue::post()
+ */
+typedef void (*LvGLCommandFn)(lv_obj_t *obj, intptr_t arg);
+#endif
+
+#define LVGL_TOUCH_MEDIAN_MAX 7 ///< Largest median filter window
+
+/**
+ * @brief Touch filter settings, see Adafruit_LvGL_Glue::setTouchFilter().
+ * All zero (the default) passes samples straight through. Something like
+ * {3, 2, 2} suits most resistive (ADC) touchscreens.
+ */
+typedef struct {
+  uint8_t median;    ///< Median-of-N window, rejects spikes (0/1 = off)
+  uint8_t smooth;    ///< IIR smoothing, each sample weighs 1/2^N (0 = off)
+  uint8_t dead_zone; ///< Pixels of jitter ignored around the reported point
+} LvGLTouchFilter;
+
+/**
+ * @brief Integer-only touch sample filter: median, IIR smoothing, then a
+ * dead zone, applied to calibrated screen coordinates. Used by the glue
+ * for both touchscreen types; standalone so it can be tested on recorded
+ * sample traces.
+ */
+class Adafruit_LvGL_TouchFilter {
+public:
+  Adafruit_LvGL_TouchFilter(void);
+  void configure(const LvGLTouchFilter *filter);
+  void reset(void);
+  void process(lv_coord_t *x, lv_coord_t *y);
+
+private:
+  LvGLTouchFilter config;
+  lv_coord_t history_x[LVGL_TOUCH_MEDIAN_MAX];
+  lv_coord_t history_y[LVGL_TOUCH_MEDIAN_MAX];
+  uint8_t history_count;
+  uint8_t history_next;
+  int32_t smooth_x, smooth_y; // 4 fractional bits
+  lv_coord_t out_x, out_y;
+  bool primed;
+};
+
 /**
  * @brief Class to act as a "glue" layer between the LvGL graphics library and
  * most of Adafruit's TFT displays
@@ -34,31 +175,127 @@ public:
   LvGLStatus begin(Adafruit_SPITFT *tft, TouchScreen *touch,
                    bool debug = false);
   LvGLStatus begin(Adafruit_SPITFT *tft, bool debug = false);
+  lv_disp_t *getDisplay(void) const;
+  void end(void);
+  void suspend(bool release_buffers = false);
+  LvGLStatus resume(void);
+  bool isSuspended(void) const;
+  static uint32_t service(void);
+  static void wake(void);
+  void setBufferSize(LvGLBufferMode mode, uint32_t amount = 0);
+  uint32_t getBufferPixels(void) const;
+  uint16_t getBufferRows(void) const;
+  uint8_t getBufferCount(void) const;
+  void setMemoryPolicy(LvGLMemoryPolicy policy, uint32_t bounce_pixels = 0);
+  bool getBufferExternal(void) const;
+  void setFlushCost(uint32_t pixels);
+  void setSwapPolicy(LvGLSwapPolicy policy);
+  void setBusChunk(uint32_t pixels);
+  static void setBusPriority(LvGLBusClient client, uint8_t priority);
+  static void busAcquire(LvGLBusClient client);
+  void setFlushTap(LvGLFlushTap tap, void *user_data = NULL);
+  static void swapBytes(uint16_t *pixels, uint32_t count);
+  uint32_t getAreasRaw(void) const;
+  uint32_t getAreasMerged(void) const;
+  void getStats(LvGLStats *stats, bool reset = false);
+  void resetStats(void);
+  LvGLStatus calibrateTouch(void);
+  void setTouchCalibration(const LvGLTouchCalibration *cal);
+  void getTouchCalibration(LvGLTouchCalibration *cal) const;
+  static bool computeTouchCalibration(const lv_point_t screen[3],
+                                      const lv_point_t raw[3],
+                                      LvGLTouchCalibration *cal);
+  void setTouchInterrupt(int8_t pin);
+  void setTouchFilter(const LvGLTouchFilter *filter);
   // These items need to be public for some internal callbacks,
   // but should be avoided by user code please!
   Adafruit_SPITFT *display; ///< Pointer to the SPITFT display instance
   void *touchscreen;        ///< Pointer to the touchscreen object to use
   bool is_adc_touch; ///< determines if the touchscreen controlelr is ADC based
-  bool first_frame;  ///< Tracks if a call to `lv_flush_callback` needs to wait
-                     ///< for DMA transfer to complete
+  void flush(const lv_area_t *area, lv_color_t *color_p);
+  void readTouch(lv_indev_data_t *data);
+  void touchInterrupt(void);
+  void touchWake(void);
+  void flushWait(void);
+  void flushPoll(void);
+  void flushContinue(void);
+  void coalesceAreas(lv_disp_t *disp);
 
 #ifdef ESP32
+  static bool setTaskConfig(const LvGLTaskConfig *config);
+  static bool post(LvGLCommandFn fn, lv_obj_t *obj, intptr_t arg = 0,
+                   bool coalesce = false);
   void lvgl_acquire(); ///< Acquires the lock around the lvgl object
   void lvgl_release(); ///< Releases the lock around the lvgl object
 #endif
 
 private:
+  friend class Adafruit_LvGL_Glue_SD; // Blits images via the draw buffers
   LvGLStatus begin(Adafruit_SPITFT *tft, void *touch, bool debug);
-  static lv_disp_drv_t lv_disp_drv;
-  static lv_disp_draw_buf_t lv_disp_draw_buf;
-  static lv_color_t *lv_pixel_buf;
-  static lv_indev_drv_t lv_indev_drv;
+  bool allocBuffers(lv_coord_t hor_res, lv_coord_t ver_res);
+  void flushDone(void);
+  void frameOpen(uint32_t now);
+  void dmaWait(void);
+  void defaultTouchCalibration(void);
+  bool readRawTouch(int32_t *x, int32_t *y);
+  void removeDisplay(void);
+  void freeBuffers(void);
+  void parkBuffers(void);
+  void flushBounce(const uint16_t *src, uint16_t width, uint32_t pixels,
+                   uint32_t stride);
+  const lv_area_t *directArea(const lv_area_t *screen);
+  void sendChunk(void);
+  void busOpen(void);
+  void busClose(void);
+  void busYield(void);
+  lv_disp_drv_t lv_disp_drv;
+  lv_disp_draw_buf_t lv_disp_draw_buf;
+  lv_color_t *lv_pixel_buf;
+  uint16_t *lv_bounce_buf; // Internal RAM, for sending PSRAM draw buffers
+  lv_indev_drv_t lv_indev_drv;
+  lv_disp_t *lv_disp;
   lv_indev_t *lv_input_dev_ptr;
-#if defined(ARDUINO_ARCH_SAMD)
-  Adafruit_ZeroTimer *zerotimer;
-#elif defined(ESP32)
+  LvGLMemoryPolicy memory_policy;
+  uint32_t bounce_amount; // As passed to setMemoryPolicy()
+  uint32_t bounce_pixels; // Per bounce buffer, 0 if none
+  LvGLBufferMode buffer_mode;
+  uint32_t buffer_amount;
+  uint32_t buffer_pixels;
+  uint8_t buffer_count;
+  LvGLSwapPolicy swap_policy;
+  uint32_t flush_cost;
+  volatile bool flush_pending; // Transfer in flight, LittlevGL not told yet
+  bool flush_last;             // In-flight transfer ends a display refresh
+  bool write_open;             // Display SPI transaction is open
+  bool swap_pixels;            // Glue byte-swaps draw buffers before sending
+  uint32_t bus_chunk;          // As passed to setBusChunk()
+  lv_area_t chunk_area;        // Rows of the flushed area not yet sent
+  uint16_t *chunk_next;        // Their pixels
+  uint32_t chunk_left;         // Pixels not yet sent
+  uint32_t chunk_pixels;       // Per chunk, whole rows
+  uint32_t chunk_stride;       // Pixels from one row's start to the next
+  uint16_t direct_next;        // Direct mode: next of lv_disp->inv_areas
+  LvGLFlushTap flush_tap;
+  void *flush_tap_data;
+  LvGLStats stats;
+  uint64_t frame_us_total;
+  bool frame_open;       // A refresh is under way, frame_start is valid
+  uint32_t frame_start;  // micros() at start of current refresh
+  uint32_t render_mark;  // micros() at refresh start or end of last flush
+  uint32_t wait_mark;    // stats.dma_wait_us at the same point
+  uint32_t wait_start;   // micros() LittlevGL started waiting, 0 if not
+  LvGLTouchCalibration touch_cal;
+  bool touch_cal_custom;      // touch_cal came from setTouchCalibration()
+  uint8_t touch_cal_rotation; // Display rotation the default was made for
+  int8_t touch_irq_pin;         // STMPE610 INT pin, or -1 to poll
+  volatile bool touch_irq_flag; // INT fired since last serviced
+  bool touch_active;            // Contact in progress, keep reading
+  Adafruit_LvGL_TouchFilter touch_filter;
+  lv_coord_t touch_x, touch_y; // Last pressed position
+  uint8_t touch_release_count; // ADC: successive no-pressure reads
+  bool suspended;
+#if defined(ESP32)
   Ticker tick;
-#elif defined(NRF52_SERIES)
 #endif
 };
 
@@ -0,0 +1,133 @@
+// Board profiles for Adafruit_LvGL_Glue: the board-specific settings used
+// by the glue (and by lv_conf.h), gathered in one place and fixed at
+// compile time. Plain preprocessor, since LittlevGL's C sources see it too.
+// Code for draw buffer kinds and touch controllers a board leaves out is
+// compiled out of flush() and readTouch(). Options set through the API at
+// run time (setSwapPolicy(), setFlushTap(), setBusChunk()) still branch at
+// run time.
+//
+// Every setting is only defined here if it isn't already, so a board can
+// be added or a setting changed without editing the library: either with
+// -D build flags, or in a file named lvgl_glue_board.h anywhere on the
+// include path, which is picked up first (as LittlevGL does lv_conf.h).
+
+#ifndef _ADAFRUIT_LVGL_GLUE_BOARD_H_
+#define _ADAFRUIT_LVGL_GLUE_BOARD_H_
+
+#if defined(__has_include)
+#if __has_include("lvgl_glue_board.h")
+#include "lvgl_glue_board.h"
+#endif
+#endif
+
+// Screen size given to LittlevGL, or 0 to use the display's width() and
+// height(). The ST7789 library (used by CLUE and TFT Gizmo for Circuit
+// Playground Express/Bluefruit) is sort of low-level rigged to a 240x320
+// screen, so those boards set it manually...
+#if !defined(LVGL_BOARD_HOR_RES)
+#if defined(ARDUINO_NRF52840_CLUE) || defined(ARDUINO_NRF52840_CIRCUITPLAY) || \
+    defined(ARDUINO_SAMD_CIRCUITPLAYGROUND_EXPRESS)
+#define LVGL_BOARD_HOR_RES 240
+#define LVGL_BOARD_VER_RES 240
+#else
+#define LVGL_BOARD_HOR_RES 0
+#define LVGL_BOARD_VER_RES 0
+#endif
+#endif
+
+// Draw buffer height for LVGL_BUFFER_DEFAULT. This is also the floor that
+// LVGL_BUFFER_AUTO backs off to if allocation fails. Actual RAM usage will
+// be 2X these figures when using 2 DMA buffers...
+#if !defined(LVGL_BOARD_BUFFER_ROWS)
+#if defined(_SAMD21_)
+#define LVGL_BOARD_BUFFER_ROWS 4 // Don't hog all the RAM on SAMD21
+#else
+#define LVGL_BOARD_BUFFER_ROWS 8 // Most others have a bit more space
+#endif
+#endif
+
+// 1 if LittlevGL should render RGB565 in display byte order (becomes
+// LV_COLOR_16_SWAP in lv_conf.h), as for the PyPortal's parallel display.
+// Otherwise the glue or Adafruit_SPITFT swaps as pixels are sent.
+#if !defined(LVGL_BOARD_COLOR_SWAP)
+#if defined(ADAFRUIT_PYPORTAL)
+#define LVGL_BOARD_COLOR_SWAP 1
+#else
+#define LVGL_BOARD_COLOR_SWAP 0
+#endif
+#endif
+
+// Who byte-swaps pixels for the display when LittlevGL doesn't render in
+// its byte order, under LVGL_SWAP_AUTO (see setSwapPolicy()). The ESP32's
+// SPI driver swaps as it fills the FIFO, at no extra cost, so
+// Adafruit_SPITFT does it there. Elsewhere Adafruit_SPITFT swaps a pixel
+// at a time, and the glue's word-at-a-time swap is faster.
+#if !defined(LVGL_BOARD_SWAP)
+#if defined(ESP32)
+#define LVGL_BOARD_SWAP LVGL_SWAP_GFX
+#else
+#define LVGL_BOARD_SWAP LVGL_SWAP_GLUE
+#endif
+#endif
+
+// 1 if the display shares its SPI bus with the touchscreen or SD card, so
+// their accesses wait on display transfers (see busAcquire()). Parallel
+// displays (PyPortal) have a bus of their own, and the waits compile out.
+#if !defined(LVGL_BOARD_SHARED_BUS)
+#if defined(ADAFRUIT_PYPORTAL)
+#define LVGL_BOARD_SHARED_BUS 0
+#else
+#define LVGL_BOARD_SHARED_BUS 1
+#endif
+#endif
+
+// Draw buffer kinds flush() is built to handle. 0 leaves that code out:
+// LVGL_BUFFER_DIRECT then gets a plain LVGL_BUFFER_FULL buffer, and draw
+// buffers always go in internal RAM (no PSRAM bounce buffer).
+#if !defined(LVGL_BOARD_DIRECT)
+#if defined(_SAMD21_)
+#define LVGL_BOARD_DIRECT 0 // No RAM for a whole-screen buffer
+#else
+#define LVGL_BOARD_DIRECT 1
+#endif
+#endif
+#if !defined(LVGL_BOARD_PSRAM)
+#if defined(ESP32)
+#define LVGL_BOARD_PSRAM 1 // Used if the module has it
+#else
+#define LVGL_BOARD_PSRAM 0
+#endif
+#endif
+
+// Touch controller, if the board's is fixed. ADC or STMPE610 leaves out
+// reading the other kind, and begin() with the other kind then returns
+// LVGL_ERR_TOUCH. ANY decides by which begin() was called.
+#define LVGL_BOARD_TOUCH_ANY 0      ///< Either, chosen at begin()
+#define LVGL_BOARD_TOUCH_ADC 1      ///< Resistive, read by TouchScreen
+#define LVGL_BOARD_TOUCH_STMPE610 2 ///< Adafruit_STMPE610 over SPI
+#if !defined(LVGL_BOARD_TOUCH)
+#if defined(ADAFRUIT_PYPORTAL)
+#define LVGL_BOARD_TOUCH LVGL_BOARD_TOUCH_ADC
+#else
+#define LVGL_BOARD_TOUCH LVGL_BOARD_TOUCH_ANY
+#endif
+#endif
+
+// Hardware timer for LittlevGL's tick, unless LV_TICK_CUSTOM is set in
+// lv_conf.h (ESP32 uses esp_timer instead)
+#if defined(ARDUINO_ARCH_SAMD)
+// Because of the way timer/counters are paired, and because parallel TFT
+// uses timer 2 for write strobe, this needs to use timer 4 or above...
+#if !defined(LVGL_BOARD_TIMER_NUM)
+#define LVGL_BOARD_TIMER_NUM 4           ///< Adafruit_ZeroTimer number
+#define LVGL_BOARD_TIMER_ISR TC4_Handler ///< Its interrupt handler
+#endif
+#elif defined(NRF52_SERIES)
+#if !defined(LVGL_BOARD_TIMER)
+#define LVGL_BOARD_TIMER NRF_TIMER4             ///< Timer peripheral
+#define LVGL_BOARD_TIMER_IRQN TIMER4_IRQn       ///< Its interrupt
+#define LVGL_BOARD_TIMER_ISR TIMER4_IRQHandler ///< Its interrupt handler
+#endif
+#endif
+
+#endif // _ADAFRUIT_LVGL_GLUE_BOARD_H_
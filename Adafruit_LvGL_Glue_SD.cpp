@@ -1,24 +1,49 @@
 #include "Adafruit_LvGL_Glue_SD.h"
 
-static void waitForDisplay(Adafruit_SPITFT *display) {
-  // Before accessing SD, wait on any in-progress
-  // DMA screen transfer to finish (shared bus).
-  display->dmaWait();
-  display->endWrite();
+static void waitForDisplay(void) {
+  // Before accessing SD, get the bus from the display (shared bus).
+  // Returns at once if SD had it last.
+  Adafruit_LvGL_Glue::busAcquire(LVGL_BUS_SD);
 }
 
+// SD cards transfer whole 512-byte blocks; cache refills are aligned to
+// these, and cache sizes rounded up to them.
+#define SD_BLOCK_SIZE 512
+
+// Default read cache per open file. LittlevGL's image decoder reads .bin
+// files a line at a time; with the cache most of those reads never touch
+// the card (or wait on the display's bus).
+#define SD_CACHE_DEFAULT (4 * SD_BLOCK_SIZE)
+
+// Default glyph cache per font from loadFont(), enough for a few dozen
+// glyphs of a typical 16-24 px font
+#define FONT_CACHE_DEFAULT 4096
+
+// An open file, plus its read cache: cache_len bytes of the file starting
+// at cache_pos (block-aligned).
+typedef struct {
+  file_t file;
+  uint32_t pos;      // Position as LittlevGL sees it
+  uint32_t card_pos; // Position of the underlying file
+  uint32_t cache_pos;
+  uint32_t cache_len;
+  uint8_t *cache; // NULL if caching is off
+} sd_file_t;
+
 // Callback functions to support reading images from SD cards
 static void *sd_open(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode) {
   Adafruit_LvGL_Glue_SD *glue = (Adafruit_LvGL_Glue_SD *)drv->user_data;
-  waitForDisplay(glue->display);
+  waitForDisplay();
 
-  // Support only reading
-  if (mode != LV_FS_MODE_RD) {
-    return NULL;
+  // Writing creates the file, and without reading also truncates it
+  int oflag = O_RDONLY;
+  if (mode & LV_FS_MODE_WR) {
+    oflag = (mode & LV_FS_MODE_RD) ? (O_RDWR | O_CREAT)
+                                   : (O_WRONLY | O_CREAT | O_TRUNC);
   }
 
   SdFat *sd = glue->sd;
-  file_t file = sd->open(path);
+  file_t file = sd->open(path, oflag);
 
   if (!file) {
     LV_LOG_ERROR("Failed to open file %s", path);
@@ -29,57 +54,1221 @@ static void *sd_open(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode) {
     return NULL;
   }
 
-  file_t *fp = (file_t *)lv_mem_alloc(sizeof(file_t));
+  sd_file_t *fp = (sd_file_t *)lv_mem_alloc(sizeof(sd_file_t));
 
   if (fp == NULL) {
     return NULL;
   }
 
-  *fp = file;
+  fp->file = file;
+  fp->pos = fp->card_pos = 0;
+  fp->cache_pos = fp->cache_len = 0;
+  // Cache comes from the heap, not LittlevGL's (smaller) pool. Reads
+  // still work without one, just slower.
+  fp->cache = (glue->cache_size && (mode & LV_FS_MODE_RD))
+                  ? (uint8_t *)malloc(glue->cache_size)
+                  : NULL;
   return fp;
 }
 
 static lv_fs_res_t sd_read(struct _lv_fs_drv_t *drv, void *file_p, void *buf,
                            uint32_t btr, uint32_t *br) {
   Adafruit_LvGL_Glue_SD *glue = (Adafruit_LvGL_Glue_SD *)drv->user_data;
-  waitForDisplay(glue->display);
+  sd_file_t *fp = (sd_file_t *)file_p;
+  uint8_t *dst = (uint8_t *)buf;
+  bool missed = false;
+  *br = 0;
+
+  while (*br < btr) {
+    uint32_t want = btr - *br;
+    if (fp->cache && (fp->pos >= fp->cache_pos) &&
+        (fp->pos < fp->cache_pos + fp->cache_len)) { // Cache hit
+      uint32_t n = fp->cache_pos + fp->cache_len - fp->pos;
+      if (n > want) {
+        n = want;
+      }
+      memcpy(&dst[*br], &fp->cache[fp->pos - fp->cache_pos], n);
+      fp->pos += n;
+      *br += n;
+      continue;
+    }
+
+    if (!missed) { // Going to the card, get the bus from the display
+      waitForDisplay();
+      missed = true;
+    }
+    // Read straight into the caller's buffer if there's no cache, or if
+    // at least a cache's worth is wanted from a block boundary. Whole
+    // blocks of it then go direct: SdFat skips its own sector buffer for
+    // those and transfers them all in one multi-block read.
+    bool direct = !fp->cache || (!(fp->pos & (SD_BLOCK_SIZE - 1)) &&
+                                 (want >= glue->cache_size));
+    // Otherwise refill the cache from the block holding pos
+    uint32_t from = direct ? fp->pos : (fp->pos & ~(SD_BLOCK_SIZE - 1));
+    if ((fp->card_pos != from) && !fp->file.seek(from)) {
+      return LV_FS_RES_FS_ERR;
+    }
+    if (direct && fp->cache) {
+      want &= ~(SD_BLOCK_SIZE - 1); // Any tail comes via the cache
+    }
+    int got = direct ? fp->file.read(&dst[*br], want)
+                     : fp->file.read(fp->cache, glue->cache_size);
+    if (got < 0) {
+      fp->cache_len = 0;
+      return LV_FS_RES_FS_ERR;
+    }
+    fp->card_pos = from + got;
+    glue->cache_stats.card_reads++;
+    glue->cache_stats.card_bytes += got;
+    if (direct) {
+      glue->cache_stats.direct_reads++;
+      fp->pos += got;
+      *br += got;
+      if ((uint32_t)got < want) {
+        break; // End of file
+      }
+    } else {
+      fp->cache_pos = from;
+      fp->cache_len = got;
+      if ((uint32_t)got <= fp->pos - from) {
+        break; // End of file
+      }
+    }
+  }
 
-  file_t *fp = (file_t *)file_p;
-  *br = fp->read(buf, btr);
+  if (missed) {
+    glue->cache_stats.misses++;
+  } else {
+    glue->cache_stats.hits++;
+  }
+  return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t sd_write(struct _lv_fs_drv_t *drv, void *file_p,
+                            const void *buf, uint32_t btw, uint32_t *bw) {
+  sd_file_t *fp = (sd_file_t *)file_p;
+  waitForDisplay();
+
+  *bw = 0;
+  if ((fp->card_pos != fp->pos) && !fp->file.seek(fp->pos)) {
+    return LV_FS_RES_FS_ERR;
+  }
+  fp->cache_len = 0; // May hold what was just overwritten
+  *bw = fp->file.write(buf, btw);
+  fp->pos += *bw;
+  fp->card_pos = fp->pos;
 
-  return (*br != -1) ? LV_FS_RES_OK : LV_FS_RES_FS_ERR;
+  return (*bw == btw) ? LV_FS_RES_OK : LV_FS_RES_FULL;
 }
 
 static lv_fs_res_t sd_close(lv_fs_drv_t *drv, void *file_p) {
-  Adafruit_LvGL_Glue_SD *glue = (Adafruit_LvGL_Glue_SD *)drv->user_data;
-  waitForDisplay(glue->display);
+  waitForDisplay();
 
-  file_t *fp = (file_t *)file_p;
-  lv_fs_res_t result = fp->close() ? LV_FS_RES_OK : LV_FS_RES_UNKNOWN;
+  sd_file_t *fp = (sd_file_t *)file_p;
+  lv_fs_res_t result = fp->file.close() ? LV_FS_RES_OK : LV_FS_RES_UNKNOWN;
+  free(fp->cache);
   lv_mem_free(fp);
 
   return result;
 }
 
+// Only moves the position LittlevGL sees; the card is seeked when (and
+// if) a read misses the cache. Offsets from the current position or end
+// may be negative, as two's complement.
 static lv_fs_res_t sd_seek(lv_fs_drv_t *drv, void *file_p, uint32_t pos,
                            lv_fs_whence_t whence) {
-  Adafruit_LvGL_Glue_SD *glue = (Adafruit_LvGL_Glue_SD *)drv->user_data;
-  waitForDisplay(glue->display);
-
-  file_t *fp = (file_t *)file_p;
-  return fp->seek(pos) ? LV_FS_RES_OK : LV_FS_RES_UNKNOWN;
+  sd_file_t *fp = (sd_file_t *)file_p;
+  switch (whence) {
+  case LV_FS_SEEK_SET:
+    fp->pos = pos;
+    break;
+  case LV_FS_SEEK_CUR:
+    fp->pos += pos;
+    break;
+  case LV_FS_SEEK_END:
+    fp->pos = fp->file.size() + pos; // Size is known, no card access
+    break;
+  default:
+    return LV_FS_RES_INV_PARAM;
+  }
+  return LV_FS_RES_OK;
 }
 
 static lv_fs_res_t sd_tell(lv_fs_drv_t *drv, void *file_p, uint32_t *pos_p) {
-  Adafruit_LvGL_Glue_SD *glue = (Adafruit_LvGL_Glue_SD *)drv->user_data;
-  waitForDisplay(glue->display);
-
-  file_t *fp = (file_t *)file_p;
-  *pos_p = fp->position();
+  sd_file_t *fp = (sd_file_t *)file_p;
+  *pos_p = fp->pos;
 
   return LV_FS_RES_OK;
 }
 
+/**
+ * @brief Construct a new Adafruit_LvGL_Glue_SD object, with the default
+ * read cache size
+ */
+Adafruit_LvGL_Glue_SD::Adafruit_LvGL_Glue_SD(void)
+    : sd(NULL), cache_size(SD_CACHE_DEFAULT), capture_file(NULL),
+      capture_row(NULL), font_cache_size(FONT_CACHE_DEFAULT) {
+  memset(&cache_stats, 0, sizeof(cache_stats));
+}
+
+/**
+ * @brief Set the size of the read cache kept for each open file. Reads
+ * are served from the cache where possible, and misses refill it with one
+ * multi-block read from the card, so sequential reads (e.g. images) cost
+ * a card transaction every few kilobytes instead of every line. Applies
+ * to files opened afterward.
+ *
+ * @param bytes Cache size, rounded up to whole 512-byte blocks; 0 reads
+ * straight from the card
+ */
+void Adafruit_LvGL_Glue_SD::setReadCache(uint32_t bytes) {
+  cache_size = (bytes + SD_BLOCK_SIZE - 1) & ~(SD_BLOCK_SIZE - 1);
+}
+
+/**
+ * @brief Get read cache statistics gathered since begin() or the last
+ * reset
+ *
+ * @param stats Structure to fill in
+ * @param reset If true, start counting afresh after taking the snapshot
+ */
+void Adafruit_LvGL_Glue_SD::getCacheStats(LvGLSdCacheStats *stats,
+                                          bool reset) {
+  *stats = cache_stats;
+  if (reset) {
+    memset(&cache_stats, 0, sizeof(cache_stats));
+  }
+}
+
+// SD IMAGE FORMATS --------------------------------------------------------
+
+// Run-length encoded images (.rle, made with extras/tools/img_convert.py):
+//   "LVRL", then the 4-byte LittlevGL image header as in .bin files,
+//   then a table of each row's file offset (uint32_t, little-endian),
+//   then the rows. Each row is a series of packets that don't cross rows:
+//   a count byte c, then c+1 literal pixels if c < 128, or one pixel
+//   repeated c-127 times otherwise.
+// Pixels are as in .bin files of the same color format. Rows decode
+// independently, so LittlevGL can draw any part of the image without
+// decoding from the top, and the decoder only keeps one run in RAM.
+#define RLE_MAGIC "LVRL"
+#define RLE_ROWS_OFFSET 8 // Row offset table follows magic and header
+#define RLE_ROWS_WINDOW 16 // Row offsets kept in RAM at a time
+
+// Display-native images (.nat, also from img_convert.py):
+//   "LVNT", the LittlevGL image header (always LV_IMG_CF_TRUE_COLOR),
+//   then the pixels, RGB565 big-endian as the display takes them.
+// Adafruit_LvGL_Glue_SD::drawImage() sends these to the display as-is.
+// LittlevGL can draw them too, swapped to its byte order if need be
+// (none with LV_COLOR_16_SWAP).
+#define NAT_MAGIC "LVNT"
+#define NAT_PIXELS_OFFSET 8
+
+// .nat images up to this many bytes of pixels (icons and the like) are
+// read whole when opened, in one card read, and swapped once. LittlevGL
+// then draws them straight from RAM, as it does C array images, rather
+// than asking for each line. Larger ones, or any that don't fit in
+// LittlevGL's heap, are read a line at a time.
+#define NAT_RAM_MAX 8192
+
+// Decoder state for one open image
+typedef struct {
+  lv_fs_file_t file;
+  bool native;                    // .nat, else .rle
+  uint32_t rows[RLE_ROWS_WINDOW]; // Part of the row offset table...
+  lv_coord_t rows_first;          // ...starting here, -1 if none
+  lv_coord_t width;
+  uint8_t pixel_size; // Bytes per pixel
+  lv_coord_t x, y;    // Next pixel in file, y = -1 if none
+  uint8_t count;      // Pixels left in current packet
+  bool literal;       // Packet is literal pixels rather than a run
+  uint8_t run[3];     // Pixel value of a run
+} img_dsc_t;
+
+static lv_img_decoder_t *img_decoder = NULL;
+
+// Bytes per pixel of the color formats the decoder handles, else 0
+static uint8_t rle_pixel_size(uint8_t cf) {
+  switch (cf) {
+  case LV_IMG_CF_TRUE_COLOR:
+  case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+    return sizeof(lv_color_t);
+  case LV_IMG_CF_TRUE_COLOR_ALPHA:
+    return LV_IMG_PX_SIZE_ALPHA_BYTE;
+  default:
+    return 0;
+  }
+}
+
+static bool img_read(lv_fs_file_t *file, void *buf, uint32_t bytes) {
+  uint32_t got;
+  return (lv_fs_read(file, buf, bytes, &got) == LV_FS_RES_OK) &&
+         (got == bytes);
+}
+
+// Open an .rle or .nat image and read its header. Returns false if it's
+// neither, or a color format that can't be handled.
+static bool img_open_file(lv_fs_file_t *file, const char *path,
+                          lv_img_header_t *header, bool *native) {
+  const char *ext = lv_fs_get_ext(path);
+  *native = !strcmp(ext, "nat");
+  if (!*native && strcmp(ext, "rle")) {
+    return false; // Not ours, try the next decoder
+  }
+  if (lv_fs_open(file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+    return false;
+  }
+  uint8_t buf[8];
+  if (img_read(file, buf, sizeof(buf)) &&
+      !memcmp(buf, *native ? NAT_MAGIC : RLE_MAGIC, 4)) {
+    memcpy(header, &buf[4], sizeof(lv_img_header_t));
+    if (*native ? (header->cf == LV_IMG_CF_TRUE_COLOR)
+                : rle_pixel_size(header->cf)) {
+      return true;
+    }
+  }
+  lv_fs_close(file);
+  return false;
+}
+
+static lv_res_t img_info(lv_img_decoder_t *decoder, const void *src,
+                         lv_img_header_t *header) {
+  lv_fs_file_t file;
+  bool native;
+  if ((lv_img_src_get_type(src) != LV_IMG_SRC_FILE) ||
+      !img_open_file(&file, (const char *)src, header, &native)) {
+    return LV_RES_INV;
+  }
+  lv_fs_close(&file);
+  return LV_RES_OK;
+}
+
+static lv_res_t img_open(lv_img_decoder_t *decoder,
+                         lv_img_decoder_dsc_t *dsc) {
+  if (dsc->src_type != LV_IMG_SRC_FILE) {
+    return LV_RES_INV;
+  }
+  img_dsc_t *img = (img_dsc_t *)lv_mem_alloc(sizeof(img_dsc_t));
+  if (!img) {
+    return LV_RES_INV;
+  }
+  lv_img_header_t header;
+  if (!img_open_file(&img->file, (const char *)dsc->src, &header,
+                     &img->native)) {
+    lv_mem_free(img);
+    return LV_RES_INV;
+  }
+  img->pixel_size = img->native ? sizeof(lv_color_t)
+                                : rle_pixel_size(dsc->header.cf);
+  img->width = dsc->header.w;
+  img->rows_first = -1;
+  img->y = -1;
+  dsc->img_data = NULL; // Drawn a line at a time with img_read_line()...
+  dsc->user_data = img;
+  uint32_t bytes = (uint32_t)header.w * header.h * sizeof(uint16_t);
+  uint8_t *pixels;
+  if (img->native && (bytes <= NAT_RAM_MAX) &&
+      (pixels = (uint8_t *)lv_mem_alloc(bytes))) { // ...or from RAM
+    if (img_read(&img->file, pixels, bytes)) {
+#if !LV_COLOR_16_SWAP
+      Adafruit_LvGL_Glue::swapBytes((uint16_t *)pixels, bytes / 2);
+#endif
+      dsc->img_data = pixels;
+      lv_fs_close(&img->file);
+      lv_mem_free(img);
+      dsc->user_data = NULL;
+    } else {
+      lv_mem_free(pixels); // Try it a line at a time
+    }
+  }
+  return LV_RES_OK;
+}
+
+// Decode n pixels into out, or skip them if out is NULL
+static bool rle_take(img_dsc_t *rle, uint8_t *out, lv_coord_t n) {
+  while (n > 0) {
+    if (!rle->count) { // Start of the next packet
+      uint8_t c;
+      if (!img_read(&rle->file, &c, 1)) {
+        return false;
+      }
+      rle->literal = (c < 128);
+      rle->count = (c & 0x7F) + 1;
+      if (!rle->literal && !img_read(&rle->file, rle->run, rle->pixel_size)) {
+        return false;
+      }
+    }
+    uint8_t m = (n < rle->count) ? n : rle->count;
+    uint32_t bytes = m * rle->pixel_size;
+    if (rle->literal) {
+      if (out) {
+        if (!img_read(&rle->file, out, bytes)) {
+          return false;
+        }
+      } else if (lv_fs_seek(&rle->file, bytes, LV_FS_SEEK_CUR) !=
+                 LV_FS_RES_OK) {
+        return false;
+      }
+    } else if (out) {
+      for (uint8_t i = 0; i < m; i++) {
+        memcpy(&out[i * rle->pixel_size], rle->run, rle->pixel_size);
+      }
+    }
+    if (out) {
+      out += bytes;
+    }
+    rle->count -= m;
+    rle->x += m;
+    n -= m;
+  }
+  return true;
+}
+
+// Move to the start of row y, via the row offset table
+static bool rle_seek_row(img_dsc_t *rle, lv_coord_t y) {
+  if ((rle->rows_first < 0) || (y < rle->rows_first) ||
+      (y >= rle->rows_first + RLE_ROWS_WINDOW)) { // Load table around y
+    uint8_t table[RLE_ROWS_WINDOW * 4];
+    uint32_t got;
+    if ((lv_fs_seek(&rle->file, RLE_ROWS_OFFSET + y * 4, LV_FS_SEEK_SET) !=
+         LV_FS_RES_OK) ||
+        (lv_fs_read(&rle->file, table, sizeof(table), &got) != LV_FS_RES_OK) ||
+        (got < 4)) {
+      return false;
+    }
+    for (uint8_t i = 0; i < got / 4; i++) {
+      const uint8_t *p = &table[i * 4];
+      rle->rows[i] =
+          p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+    rle->rows_first = y;
+  }
+  if (lv_fs_seek(&rle->file, rle->rows[y - rle->rows_first],
+                 LV_FS_SEEK_SET) != LV_FS_RES_OK) {
+    return false;
+  }
+  rle->y = y;
+  rle->x = 0;
+  rle->count = 0;
+  return true;
+}
+
+static bool nat_read_line(img_dsc_t *img, lv_coord_t x, lv_coord_t y,
+                          lv_coord_t len, uint8_t *buf) {
+  if ((lv_fs_seek(&img->file,
+                  NAT_PIXELS_OFFSET +
+                      ((uint32_t)y * img->width + x) * sizeof(uint16_t),
+                  LV_FS_SEEK_SET) != LV_FS_RES_OK) ||
+      !img_read(&img->file, buf, len * sizeof(uint16_t))) {
+    return false;
+  }
+#if !LV_COLOR_16_SWAP
+  Adafruit_LvGL_Glue::swapBytes((uint16_t *)buf, len); // To LittlevGL's order
+#endif
+  return true;
+}
+
+static lv_res_t img_read_line(lv_img_decoder_t *decoder,
+                              lv_img_decoder_dsc_t *dsc, lv_coord_t x,
+                              lv_coord_t y, lv_coord_t len, uint8_t *buf) {
+  if (dsc->img_data) { // Small .nat, in RAM (LittlevGL doesn't ask)
+    memcpy(buf, &dsc->img_data[((uint32_t)y * dsc->header.w + x) * 2],
+           len * 2);
+    return LV_RES_OK;
+  }
+  img_dsc_t *rle = (img_dsc_t *)dsc->user_data;
+  if (rle->native) {
+    return nat_read_line(rle, x, y, len, buf) ? LV_RES_OK : LV_RES_INV;
+  }
+  bool ok = true;
+  if ((rle->y >= 0) && (y == rle->y + 1)) {
+    // Next row, which follows on in the file: skip the rest of this one
+    ok = rle_take(rle, NULL, rle->width - rle->x);
+    rle->y = y;
+    rle->x = 0;
+  } else if ((y != rle->y) || (x < rle->x)) { // Elsewhere, look it up
+    ok = rle_seek_row(rle, y);
+  }
+  if (!ok) {
+    rle->y = -1;
+    return LV_RES_INV;
+  }
+  if (!rle_take(rle, NULL, x - rle->x) || !rle_take(rle, buf, len)) {
+    rle->y = -1;
+    return LV_RES_INV;
+  }
+  return LV_RES_OK;
+}
+
+static void img_close(lv_img_decoder_t *decoder, lv_img_decoder_dsc_t *dsc) {
+  img_dsc_t *img = (img_dsc_t *)dsc->user_data;
+  if (img) {
+    lv_fs_close(&img->file);
+    lv_mem_free(img);
+    dsc->user_data = NULL;
+  }
+  if (dsc->img_data) {
+    lv_mem_free((void *)dsc->img_data);
+    dsc->img_data = NULL;
+  }
+}
+
+/**
+ * @brief Draw a display-native (.nat) image from SD straight to the
+ * display, bypassing LittlevGL: rows are read into the (idle) draw buffer
+ * and sent from there as-is, with no decoding, byte swapping or rendering.
+ * With LVGL_BUFFER_DIRECT they're read into place in the kept frame.
+ * This is a one-off blit, not managed by LittlevGL: nothing redraws it,
+ * and LittlevGL draws over it when it next refreshes that part of the
+ * display. For splash screens, or anything else shown while LittlevGL's
+ * screen is being built. Use an lv_img for images that are part of the UI
+ * (small .nat images, up to 8 KB, are then read whole and drawn from RAM).
+ *
+ * @param path Image file, as LittlevGL sees it (e.g. "S:/splash.nat")
+ * @param x Left edge on the display
+ * @param y Top edge on the display; parts off the display are skipped
+ * @return true on success, false if the display isn't running or the file
+ * couldn't be read (or isn't a .nat image)
+ */
+bool Adafruit_LvGL_Glue_SD::drawImage(const char *path, lv_coord_t x,
+                                      lv_coord_t y) {
+  lv_disp_t *disp = getDisplay();
+  if (!disp || isSuspended()) {
+    return false;
+  }
+#ifdef ESP32
+  lvgl_acquire();
+#endif
+  flushWait(); // Draw buffers are free once nothing is in flight
+  lv_fs_file_t file;
+  lv_img_header_t header;
+  bool native, ok = img_open_file(&file, path, &header, &native) && native;
+  if (ok) {
+    // Visible part of the image
+    lv_coord_t x0 = LV_MAX(x, 0), y0 = LV_MAX(y, 0);
+    lv_coord_t x1 = LV_MIN(x + (lv_coord_t)header.w, lv_disp_get_hor_res(disp));
+    lv_coord_t y1 = LV_MIN(y + (lv_coord_t)header.h, lv_disp_get_ver_res(disp));
+    uint16_t *buf = (uint16_t *)lv_pixel_buf;
+    uint32_t buf_pixels = buffer_pixels * buffer_count;
+    // A direct mode frame is kept from refresh to refresh, so rather than
+    // use it as scratch space, rows go to their own place in it
+    lv_coord_t hor_res = lv_disp_get_hor_res(disp);
+    bool in_frame =
+        LVGL_BOARD_DIRECT && lv_disp_drv.direct_mode && !lv_bounce_buf;
+    if (lv_bounce_buf) { // PSRAM draw buffers, internal RAM is faster
+      buf = lv_bounce_buf;
+      buf_pixels = bounce_pixels;
+    }
+    uint16_t width = (x1 > x0) ? (x1 - x0) : 0;
+    // Whole rows at a time if full width, else one row at a time
+    lv_coord_t rows = 1;
+    if (width && (width == header.w) && (!in_frame || (width == hor_res))) {
+      rows = LV_MIN(buf_pixels / width, (uint32_t)header.h);
+    }
+    if (width && (rows < 1)) {
+      ok = false; // Buffer smaller than a row
+    }
+    for (lv_coord_t row = y0; width && ok && (row < y1); row += rows) {
+      lv_coord_t n = LV_MIN(rows, y1 - row);
+      uint32_t pixels = (uint32_t)n * width;
+      if (in_frame) {
+        buf = (uint16_t *)&lv_pixel_buf[(uint32_t)row * hor_res + x0];
+      }
+      ok = (lv_fs_seek(&file,
+                       NAT_PIXELS_OFFSET +
+                           ((uint32_t)(row - y) * header.w + (x0 - x)) *
+                               sizeof(uint16_t),
+                       LV_FS_SEEK_SET) == LV_FS_RES_OK) &&
+           img_read(&file, buf, pixels * sizeof(uint16_t)); // Gets the bus
+      if (ok) {
+        busOpen();
+        display->setAddrWindow(x0, row, width, n);
+        // Blocking, the buffer is read into again right away (and the SD
+        // card likely needs the bus for that)
+        display->writePixels(buf, pixels, true, true);
+        busClose();
+#if !LV_COLOR_16_SWAP
+        if (in_frame) { // Frame matches the display again, in its own order
+          swapBytes(buf, pixels);
+        }
+#endif
+      }
+    }
+    lv_fs_close(&file);
+  }
+#ifdef ESP32
+  lvgl_release();
+#endif
+  return ok;
+}
+
+// SD FONTS ----------------------------------------------------------------
+
+// LittlevGL binary fonts (lv_font_conv --format bin --no-compress), used
+// from the card as needed instead of loaded whole like lv_font_load()
+// does. Only the font's header and cmap subtable headers are kept in RAM;
+// glyphs are looked up and read on first use, then kept in a fixed-size
+// cache, least recently used out first. Kerning isn't applied.
+
+// Font header, parsed from the file's head section (little-endian, fields
+// in this order and size, 40 bytes in all)
+#define FONT_HEAD_SIZE 40
+typedef struct {
+  uint32_t version;
+  uint16_t tables_count;
+  uint16_t font_size;
+  uint16_t ascent;
+  int16_t descent;
+  uint16_t typo_ascent;
+  int16_t typo_descent;
+  uint16_t typo_line_gap;
+  int16_t min_y;
+  int16_t max_y;
+  uint16_t default_advance_width;
+  uint16_t kerning_scale;
+  uint8_t index_to_loc_format;
+  uint8_t glyph_id_format;
+  uint8_t advance_width_format;
+  uint8_t bits_per_pixel;
+  uint8_t xy_bits;
+  uint8_t wh_bits;
+  uint8_t advance_width_bits;
+  uint8_t compression_id;
+  uint8_t subpixels_mode;
+  uint8_t padding;
+  int16_t underline_position;
+  uint16_t underline_thickness;
+} font_header_t;
+
+// cmap subtable header, parsed the same way (16 bytes in the file)
+#define FONT_CMAP_SIZE 16
+typedef struct {
+  uint32_t data_offset; // From start of cmap section
+  uint32_t range_start;
+  uint16_t range_length;
+  uint16_t glyph_id_start;
+  uint16_t data_entries_count;
+  uint8_t format_type;
+} font_cmap_t;
+
+enum { // font_cmap_t format_type
+  FONT_CMAP_FORMAT0_FULL,
+  FONT_CMAP_SPARSE_FULL,
+  FONT_CMAP_FORMAT0_TINY,
+  FONT_CMAP_SPARSE_TINY
+};
+
+// One cached glyph
+typedef struct {
+  uint32_t letter; // 0 if slot unused
+  uint32_t used;   // sd_font_t tick when last used
+  bool found;      // Letter is in the font
+  lv_font_glyph_dsc_t dsc;
+  const uint8_t *bitmap;
+} font_slot_t;
+
+// An open SD font. The lv_font_t handed to LittlevGL is the first member.
+typedef struct {
+  lv_font_t font;
+  lv_fs_file_t file;
+  font_header_t header;
+  font_cmap_t *cmaps;
+  uint16_t cmap_count;
+  uint32_t cmap_start; // Section positions in file
+  uint32_t loca_start;
+  uint32_t glyf_start;
+  uint32_t glyf_length;
+  uint32_t glyph_count;
+  font_slot_t *slots;
+  uint8_t *slot_bitmaps; // slot_size bytes per slot
+  uint16_t slot_count;
+  uint16_t slot_size;
+  uint32_t tick;
+  LvGLFontStats stats;
+} sd_font_t;
+
+// Little-endian values from the file, taken from p and moved past
+static uint16_t font_u16(const uint8_t **p) {
+  const uint8_t *b = *p;
+  *p += 2;
+  return b[0] | (b[1] << 8);
+}
+
+static uint32_t font_u32(const uint8_t **p) {
+  const uint8_t *b = *p;
+  *p += 4;
+  return b[0] | (b[1] << 8) | (b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+// Read a section header at start, returning its length (including the
+// header), or 0 if it's not the expected section
+static uint32_t font_section(lv_fs_file_t *file, uint32_t start,
+                             const char *label) {
+  uint8_t buf[8];
+  const uint8_t *p = buf;
+  if ((lv_fs_seek(file, start, LV_FS_SEEK_SET) != LV_FS_RES_OK) ||
+      !img_read(file, buf, sizeof(buf)) || memcmp(&buf[4], label, 4)) {
+    return 0;
+  }
+  return font_u32(&p);
+}
+
+// Read and parse the head section's font header
+static bool font_read_header(lv_fs_file_t *file, font_header_t *h) {
+  uint8_t buf[FONT_HEAD_SIZE];
+  const uint8_t *p = buf;
+  if (!img_read(file, buf, sizeof(buf))) {
+    return false;
+  }
+  h->version = font_u32(&p);
+  h->tables_count = font_u16(&p);
+  h->font_size = font_u16(&p);
+  h->ascent = font_u16(&p);
+  h->descent = font_u16(&p);
+  h->typo_ascent = font_u16(&p);
+  h->typo_descent = font_u16(&p);
+  h->typo_line_gap = font_u16(&p);
+  h->min_y = font_u16(&p);
+  h->max_y = font_u16(&p);
+  h->default_advance_width = font_u16(&p);
+  h->kerning_scale = font_u16(&p);
+  h->index_to_loc_format = *p++;
+  h->glyph_id_format = *p++;
+  h->advance_width_format = *p++;
+  h->bits_per_pixel = *p++;
+  h->xy_bits = *p++;
+  h->wh_bits = *p++;
+  h->advance_width_bits = *p++;
+  h->compression_id = *p++;
+  h->subpixels_mode = *p++;
+  h->padding = *p++;
+  h->underline_position = font_u16(&p);
+  h->underline_thickness = font_u16(&p);
+  return true;
+}
+
+// Read and parse the cmap section's subtable headers, count of them
+static bool font_read_cmaps(lv_fs_file_t *file, font_cmap_t *cmaps,
+                            uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    uint8_t buf[FONT_CMAP_SIZE];
+    const uint8_t *p = buf;
+    if (!img_read(file, buf, sizeof(buf))) {
+      return false;
+    }
+    cmaps[i].data_offset = font_u32(&p);
+    cmaps[i].range_start = font_u32(&p);
+    cmaps[i].range_length = font_u16(&p);
+    cmaps[i].glyph_id_start = font_u16(&p);
+    cmaps[i].data_entries_count = font_u16(&p);
+    cmaps[i].format_type = *p;
+  }
+  return true;
+}
+
+static bool font_read_at(sd_font_t *f, uint32_t pos, void *buf,
+                         uint32_t bytes) {
+  return (lv_fs_seek(&f->file, pos, LV_FS_SEEK_SET) == LV_FS_RES_OK) &&
+         img_read(&f->file, buf, bytes);
+}
+
+static bool font_read_u16(sd_font_t *f, uint32_t pos, uint16_t *value) {
+  uint8_t b[2];
+  const uint8_t *p = b;
+  if (!font_read_at(f, pos, b, sizeof(b))) {
+    return false;
+  }
+  *value = font_u16(&p);
+  return true;
+}
+
+// Glyph record offset for glyph id, from the loca table
+static bool font_loca(sd_font_t *f, uint32_t id, uint32_t *offset) {
+  if (id >= f->glyph_count) {
+    *offset = f->glyf_length; // End of last glyph
+    return true;
+  }
+  uint8_t b[4];
+  const uint8_t *p = b;
+  bool wide = f->header.index_to_loc_format;
+  if (!font_read_at(f, f->loca_start + id * (wide ? 4 : 2), b,
+                    wide ? 4 : 2)) {
+    return false;
+  }
+  *offset = wide ? font_u32(&p) : font_u16(&p);
+  return true;
+}
+
+// Glyph id for a letter from the cmap tables, 0 if none
+static uint32_t font_glyph_id(sd_font_t *f, uint32_t letter) {
+  for (uint16_t i = 0; i < f->cmap_count; i++) {
+    const font_cmap_t *c = &f->cmaps[i];
+    uint32_t rcp = letter - c->range_start;
+    if ((letter < c->range_start) || (rcp >= c->range_length)) {
+      continue;
+    }
+    uint32_t data = f->cmap_start + c->data_offset;
+    if (c->format_type == FONT_CMAP_FORMAT0_TINY) {
+      return c->glyph_id_start + rcp;
+    }
+    if (c->format_type == FONT_CMAP_FORMAT0_FULL) {
+      uint8_t ofs;
+      return font_read_at(f, data + rcp, &ofs, 1) ? c->glyph_id_start + ofs
+                                                  : 0;
+    }
+    // Sparse: binary search the list of code points (offsets from
+    // range_start) for the letter
+    uint16_t lo = 0, hi = c->data_entries_count, value;
+    while (lo < hi) {
+      uint16_t mid = (lo + hi) / 2;
+      if (!font_read_u16(f, data + mid * 2, &value)) {
+        return 0;
+      }
+      if (value == rcp) {
+        if (c->format_type == FONT_CMAP_SPARSE_TINY) {
+          return c->glyph_id_start + mid;
+        }
+        // SPARSE_FULL: glyph id offsets follow the code point list
+        return font_read_u16(f, data + (c->data_entries_count + mid) * 2,
+                             &value)
+                   ? c->glyph_id_start + value
+                   : 0;
+      }
+      if (value < rcp) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+  }
+  return 0;
+}
+
+// Read n bits, MSB first, from a glyph record
+static uint32_t font_bits(const uint8_t *rec, uint32_t *bit, uint8_t n) {
+  uint32_t value = 0;
+  while (n--) {
+    value = (value << 1) | ((rec[*bit / 8] >> (7 - (*bit % 8))) & 1);
+    (*bit)++;
+  }
+  return value;
+}
+
+static int32_t font_bits_signed(const uint8_t *rec, uint32_t *bit,
+                                uint8_t n) {
+  uint32_t value = font_bits(rec, bit, n);
+  return (n && (value & (1 << (n - 1)))) ? (int32_t)(value - (1 << n))
+                                         : (int32_t)value;
+}
+
+// Load letter's glyph into slot: metrics, then bitmap, shifted to start on
+// a byte boundary if need be
+static bool font_load_glyph(sd_font_t *f, font_slot_t *slot,
+                            uint32_t letter) {
+  const font_header_t *h = &f->header;
+  uint8_t *rec = (uint8_t *)slot->bitmap;
+  uint32_t id = font_glyph_id(f, letter), start, end;
+  slot->letter = letter;
+  slot->found = false;
+  if (!id || !font_loca(f, id, &start) || !font_loca(f, id + 1, &end) ||
+      (end < start) || (end - start > f->slot_size) ||
+      !font_read_at(f, f->glyf_start + start, rec, end - start)) {
+    return true; // Not in font (or unreadable), remembered as such
+  }
+  uint32_t bit = 0;
+  uint32_t adv_w = h->advance_width_bits
+                       ? font_bits(rec, &bit, h->advance_width_bits)
+                       : h->default_advance_width;
+  if (!h->advance_width_format) {
+    adv_w <<= 4; // Whole pixels, make 1/16ths
+  }
+  slot->dsc.adv_w = (adv_w + 8) >> 4;
+  slot->dsc.ofs_x = font_bits_signed(rec, &bit, h->xy_bits);
+  slot->dsc.ofs_y = font_bits_signed(rec, &bit, h->xy_bits);
+  slot->dsc.box_w = font_bits(rec, &bit, h->wh_bits);
+  slot->dsc.box_h = font_bits(rec, &bit, h->wh_bits);
+  slot->dsc.bpp = h->bits_per_pixel;
+  uint8_t shift = bit % 8;
+  uint32_t size = (end - start) - bit / 8;
+  if (shift) { // Bitmap starts mid-byte, move it back to the byte start
+    uint8_t *p = &rec[bit / 8];
+    for (uint32_t i = 0; i < size; i++) {
+      uint8_t next = (i + 1 < size) ? p[i + 1] : 0;
+      rec[i] = (p[i] << shift) | (next >> (8 - shift));
+    }
+  } else if (bit) {
+    memmove(rec, &rec[bit / 8], size);
+  }
+  slot->found = true;
+  return true;
+}
+
+// Find letter's glyph in the cache, loading it if need be. Only lookups
+// for metrics are counted; each drawn glyph's bitmap lookup follows one.
+static font_slot_t *font_glyph(sd_font_t *f, uint32_t letter, bool count) {
+  font_slot_t *oldest = &f->slots[0];
+  f->tick++;
+  for (uint16_t i = 0; i < f->slot_count; i++) {
+    font_slot_t *slot = &f->slots[i];
+    if (slot->letter == letter) {
+      f->stats.hits += count;
+      slot->used = f->tick;
+      return slot;
+    }
+    if ((f->tick - slot->used) > (f->tick - oldest->used)) {
+      oldest = slot;
+    }
+  }
+  f->stats.misses += count;
+  oldest->used = f->tick;
+  font_load_glyph(f, oldest, letter);
+  return oldest;
+}
+
+static bool font_get_glyph_dsc(const lv_font_t *font,
+                               lv_font_glyph_dsc_t *dsc_out, uint32_t letter,
+                               uint32_t letter_next) {
+  if (!letter) {
+    return false;
+  }
+  font_slot_t *slot = font_glyph((sd_font_t *)font->dsc, letter, true);
+  if (slot->found) { // Field by field, LittlevGL owns the rest of dsc_out
+    dsc_out->adv_w = slot->dsc.adv_w;
+    dsc_out->box_w = slot->dsc.box_w;
+    dsc_out->box_h = slot->dsc.box_h;
+    dsc_out->ofs_x = slot->dsc.ofs_x;
+    dsc_out->ofs_y = slot->dsc.ofs_y;
+    dsc_out->bpp = slot->dsc.bpp;
+  }
+  return slot->found;
+}
+
+static const uint8_t *font_get_glyph_bitmap(const lv_font_t *font,
+                                            uint32_t letter) {
+  // Just looked up by font_get_glyph_dsc(), so a cache hit
+  font_slot_t *slot = font_glyph((sd_font_t *)font->dsc, letter, false);
+  return slot->found ? slot->bitmap : NULL;
+}
+
+/**
+ * @brief Set the glyph cache size for fonts loaded afterward with
+ * loadFont(). Call before begin() to set it for all fonts.
+ *
+ * @param bytes Cache size per font (default 4096). At least two glyphs
+ * are always cached.
+ */
+void Adafruit_LvGL_Glue_SD::setFontCache(uint32_t bytes) {
+  font_cache_size = bytes;
+}
+
+/**
+ * @brief Load a LittlevGL binary font (made with `lv_font_conv --format bin
+ * --no-compress`) from SD. Unlike lv_font_load(), glyphs stay on the card
+ * until first used, then are cached in RAM (see setFontCache()), so large
+ * fonts and scripts cost little RAM and no flash. The file stays open
+ * until freeFont().
+ *
+ * @param path Font file, as LittlevGL sees it (e.g. "S:/noto_cjk_16.bin")
+ * @return lv_font_t* Font for lv_obj_set_style_text_font() etc., or NULL
+ * if it couldn't be loaded
+ */
+lv_font_t *Adafruit_LvGL_Glue_SD::loadFont(const char *path) {
+  sd_font_t *f = (sd_font_t *)calloc(1, sizeof(sd_font_t));
+  if (!f) {
+    return NULL;
+  }
+  if (lv_fs_open(&f->file, path, LV_FS_MODE_RD) != LV_FS_RES_OK) {
+    free(f);
+    return NULL;
+  }
+  font_header_t *h = &f->header;
+  uint32_t head_length = font_section(&f->file, 0, "head");
+  bool ok = head_length && font_read_header(&f->file, h) &&
+            !h->compression_id && h->bits_per_pixel &&
+            (h->bits_per_pixel <= 8);
+  uint32_t cmap_length = 0, loca_length = 0;
+  uint8_t count[4];
+  const uint8_t *p = count;
+  if (ok) { // cmap subtable headers, kept in RAM
+    f->cmap_start = head_length;
+    cmap_length = font_section(&f->file, f->cmap_start, "cmap");
+    ok = cmap_length && img_read(&f->file, count, sizeof(count)) &&
+         ((f->cmap_count = font_u32(&p)) < 256) &&
+         (f->cmaps =
+              (font_cmap_t *)malloc(f->cmap_count * sizeof(font_cmap_t))) &&
+         font_read_cmaps(&f->file, f->cmaps, f->cmap_count);
+  }
+  if (ok) { // Glyph offsets, left on the card
+    uint32_t loca = f->cmap_start + cmap_length;
+    loca_length = font_section(&f->file, loca, "loca");
+    p = count;
+    ok = loca_length && img_read(&f->file, count, sizeof(count)) &&
+         (f->glyph_count = font_u32(&p));
+    f->loca_start = loca + 12;
+    f->glyf_start = loca + loca_length;
+    f->glyf_length = font_section(&f->file, f->glyf_start, "glyf");
+    ok = ok && f->glyf_length;
+  }
+  if (ok) { // Largest glyph record sizes the cache slots. The offsets are
+            // read in order a block at a time, not one card access each.
+    uint8_t block[256], entry = h->index_to_loc_format ? 4 : 2;
+    uint16_t left = 0;
+    uint32_t prev = 0, next;
+    ok = lv_fs_seek(&f->file, f->loca_start, LV_FS_SEEK_SET) == LV_FS_RES_OK;
+    for (uint32_t id = 0; ok && (id <= f->glyph_count); id++) {
+      next = f->glyf_length; // End of last glyph
+      if (id < f->glyph_count) {
+        if (!left) {
+          left = LV_MIN(sizeof(block) / entry, f->glyph_count - id);
+          p = block;
+          if (!img_read(&f->file, block, left * entry)) {
+            ok = false;
+            break;
+          }
+        }
+        next = (entry == 4) ? font_u32(&p) : font_u16(&p);
+        left--;
+      }
+      ok = (next >= prev);
+      if (ok && (id > 1) && (next - prev > f->slot_size)) {
+        ok = (next - prev) <= 0xFFFF;
+        f->slot_size = next - prev;
+      }
+      prev = next;
+    }
+    uint32_t slots = font_cache_size / (f->slot_size + sizeof(font_slot_t));
+    f->slot_count = LV_MAX(2, LV_MIN(slots, 0xFFFF));
+    f->slots = (font_slot_t *)calloc(f->slot_count, sizeof(font_slot_t));
+    f->slot_bitmaps = (uint8_t *)malloc(f->slot_count * f->slot_size);
+    ok = ok && f->slots && f->slot_bitmaps;
+  }
+  if (!ok) {
+    LV_LOG_WARN("Couldn't load font %s", path);
+    freeFont(&f->font);
+    return NULL;
+  }
+  for (uint16_t i = 0; i < f->slot_count; i++) {
+    f->slots[i].bitmap = &f->slot_bitmaps[i * f->slot_size];
+  }
+
+  f->font.get_glyph_dsc = font_get_glyph_dsc;
+  f->font.get_glyph_bitmap = font_get_glyph_bitmap;
+  f->font.line_height = h->ascent - h->descent;
+  f->font.base_line = -h->descent;
+  f->font.subpx = h->subpixels_mode;
+  f->font.underline_position = h->underline_position;
+  f->font.underline_thickness = h->underline_thickness;
+  f->font.dsc = f;
+  return &f->font;
+}
+
+/**
+ * @brief Close a font from loadFont() and free its memory. Nothing may be
+ * using it any more.
+ *
+ * @param font Font to free
+ */
+void Adafruit_LvGL_Glue_SD::freeFont(lv_font_t *font) {
+  if (font) {
+    sd_font_t *f = (sd_font_t *)font; // Font is the first member
+    if (f->file.file_d) {
+      lv_fs_close(&f->file);
+    }
+    free(f->cmaps);
+    free(f->slots);
+    free(f->slot_bitmaps);
+    free(f);
+  }
+}
+
+/**
+ * @brief Get glyph cache statistics for a font from loadFont(), gathered
+ * since it was loaded or the last reset
+ *
+ * @param font Font to query
+ * @param stats Structure to fill in
+ * @param reset If true, start counting afresh after taking the snapshot
+ */
+void Adafruit_LvGL_Glue_SD::getFontStats(const lv_font_t *font,
+                                         LvGLFontStats *stats, bool reset) {
+  sd_font_t *f = (sd_font_t *)font;
+  *stats = f->stats;
+  stats->slots = f->slot_count;
+  if (reset) {
+    f->stats.hits = f->stats.misses = 0;
+  }
+}
+
+// SCREEN CAPTURE ----------------------------------------------------------
+
+// 16-bit BMP header: file header, BITMAPINFOHEADER, then the RGB565
+// channel masks (BI_BITFIELDS)
+#define BMP_HEADER_SIZE (14 + 40 + 12)
+
+static void put_le(uint8_t *p, uint32_t value, uint8_t bytes) {
+  while (bytes--) {
+    *p++ = value;
+    value >>= 8;
+  }
+}
+
+// Flush tap installed during captureScreen()
+static void capture_tap(const lv_area_t *area, const lv_color_t *pixels,
+                        void *user_data) {
+  ((Adafruit_LvGL_Glue_SD *)user_data)->captureArea(area, pixels);
+}
+
+// Move the capture file to offset, zero-filling if that's past the end
+// (areas arriving out of order, or row padding)
+bool Adafruit_LvGL_Glue_SD::captureSeek(uint32_t offset) {
+  static const uint8_t zeros[32] = {0};
+  if (offset <= capture_size) {
+    if ((offset != capture_pos) &&
+        (lv_fs_seek(capture_file, offset, LV_FS_SEEK_SET) != LV_FS_RES_OK)) {
+      return false;
+    }
+    capture_pos = offset;
+    return true;
+  }
+  if (!captureSeek(capture_size)) {
+    return false;
+  }
+  while (capture_pos < offset) {
+    uint32_t n = offset - capture_pos;
+    if (!captureWrite(zeros, (n < sizeof(zeros)) ? n : sizeof(zeros))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool Adafruit_LvGL_Glue_SD::captureWrite(const void *data, uint32_t bytes) {
+  uint32_t written;
+  if ((lv_fs_write(capture_file, data, bytes, &written) != LV_FS_RES_OK) ||
+      (written != bytes)) {
+    return false;
+  }
+  capture_pos += bytes;
+  if (capture_pos > capture_size) {
+    capture_size = capture_pos;
+  }
+  return true;
+}
+
+/**
+ * @brief Write one flushed area into the capture file, a row at a time.
+ * Called via the flush tap while captureScreen() runs.
+ *
+ * @param area Screen area being flushed
+ * @param pixels Its pixels, in LittlevGL's byte order
+ */
+void Adafruit_LvGL_Glue_SD::captureArea(const lv_area_t *area,
+                                        const lv_color_t *pixels) {
+  uint16_t width = area->x2 - area->x1 + 1;
+  for (lv_coord_t y = area->y1; capture_ok && (y <= area->y2); y++) {
+    const void *row = pixels;
+#if LV_COLOR_16_SWAP
+    // File wants little-endian, LittlevGL has big
+    memcpy(capture_row, pixels, width * sizeof(uint16_t));
+    swapBytes(capture_row, width);
+    row = capture_row;
+#endif
+    capture_ok = captureSeek(capture_header + y * capture_stride +
+                             area->x1 * sizeof(uint16_t)) &&
+                 captureWrite(row, width * sizeof(uint16_t));
+    pixels += width;
+  }
+}
+
+/**
+ * @brief Save the screen to a file on the SD card. Forces a full refresh
+ * and writes each area to the file as it's sent to the display, so no
+ * framebuffer is needed: RAM use is one row at most. The display keeps
+ * updating normally. Areas normally arrive top to bottom, so the file is
+ * written in order. Blocks until done.
+ *
+ * @param path File to write, as LittlevGL sees it (e.g. "S:/screen.bmp").
+ * Replaced if it exists.
+ * @param format LVGL_CAPTURE_BMP (16-bit RGB565 .bmp, default) or
+ * LVGL_CAPTURE_RAW (RGB565 little-endian, rows top to bottom, no header)
+ * @return true on success, false if the display isn't running or the file
+ * couldn't be written
+ */
+bool Adafruit_LvGL_Glue_SD::captureScreen(const char *path,
+                                          LvGLCaptureFormat format) {
+  lv_disp_t *disp = getDisplay();
+  if (!disp || isSuspended()) {
+    return false;
+  }
+  uint32_t width = lv_disp_get_hor_res(disp);
+  uint32_t height = lv_disp_get_ver_res(disp);
+  lv_fs_file_t file;
+#ifdef ESP32
+  lvgl_acquire();
+#endif
+  flushWait(); // Nothing half-sent before the tap goes in
+  if (lv_fs_open(&file, path, LV_FS_MODE_WR) != LV_FS_RES_OK) {
+#ifdef ESP32
+    lvgl_release();
+#endif
+    return false;
+  }
+  capture_file = &file;
+  capture_pos = capture_size = 0;
+  capture_ok = true;
+  capture_header = 0;
+  capture_stride = width * sizeof(uint16_t);
+  if (format == LVGL_CAPTURE_BMP) {
+    uint8_t header[BMP_HEADER_SIZE] = {'B', 'M'};
+    capture_header = BMP_HEADER_SIZE;
+    capture_stride = (capture_stride + 3) & ~3; // Rows pad to 4 bytes
+    uint32_t image_size = capture_stride * height;
+    put_le(&header[2], BMP_HEADER_SIZE + image_size, 4); // File size
+    put_le(&header[10], BMP_HEADER_SIZE, 4);             // Pixel data offset
+    put_le(&header[14], 40, 4);                          // Info header size
+    put_le(&header[18], width, 4);
+    put_le(&header[22], -(int32_t)height, 4); // Negative = top row first
+    put_le(&header[26], 1, 2);                // Planes
+    put_le(&header[28], 16, 2);               // Bits per pixel
+    put_le(&header[30], 3, 4);                // BI_BITFIELDS
+    put_le(&header[34], image_size, 4);
+    put_le(&header[38], 2835, 4); // 72 DPI
+    put_le(&header[42], 2835, 4);
+    put_le(&header[54], 0xF800, 4); // Red mask
+    put_le(&header[58], 0x07E0, 4); // Green mask
+    put_le(&header[62], 0x001F, 4); // Blue mask
+    capture_ok = captureWrite(header, sizeof(header));
+  }
+#if LV_COLOR_16_SWAP
+  capture_row = (uint16_t *)malloc(width * sizeof(uint16_t));
+  capture_ok = capture_ok && capture_row;
+#endif
+
+  if (capture_ok) {
+    setFlushTap(capture_tap, this);
+    lv_obj_invalidate(lv_disp_get_scr_act(disp));
+    lv_refr_now(disp);
+    flushWait();
+    setFlushTap(NULL);
+    // Pad out to full length, in case the last rows never came
+    capture_ok = capture_ok && captureSeek(capture_header +
+                                           capture_stride * height);
+  }
+
+#if LV_COLOR_16_SWAP
+  free(capture_row);
+  capture_row = NULL;
+#endif
+  capture_file = NULL;
+  if (lv_fs_close(&file) != LV_FS_RES_OK) {
+    capture_ok = false;
+  }
+#ifdef ESP32
+  lvgl_release();
+#endif
+  return capture_ok;
+}
+
 /**
  * @brief Configure the glue layer and the underlying LvGL code to use the given
  * TFT display driver, touchscreen controller and SD card instances
@@ -155,8 +1344,19 @@ void Adafruit_LvGL_Glue_SD::initFileSystem() {
   lv_fs_drv.open_cb = sd_open;
   lv_fs_drv.close_cb = sd_close;
   lv_fs_drv.read_cb = sd_read;
+  lv_fs_drv.write_cb = sd_write;
   lv_fs_drv.seek_cb = sd_seek;
   lv_fs_drv.tell_cb = sd_tell;
   lv_fs_drv.user_data = this;
   lv_fs_drv_register(&lv_fs_drv);
+
+  if (!img_decoder) { // One for all drives, and all glue instances
+    img_decoder = lv_img_decoder_create();
+    if (img_decoder) {
+      lv_img_decoder_set_info_cb(img_decoder, img_info);
+      lv_img_decoder_set_open_cb(img_decoder, img_open);
+      lv_img_decoder_set_read_line_cb(img_decoder, img_read_line);
+      lv_img_decoder_set_close_cb(img_decoder, img_close);
+    }
+  }
 }
@@ -6,6 +6,36 @@
 
 typedef File file_t;
 
+/**
+ * @brief SD read cache statistics, see Adafruit_LvGL_Glue_SD::getCacheStats()
+ */
+typedef struct {
+  uint32_t hits;         ///< LittlevGL reads served entirely from cache
+  uint32_t misses;       ///< LittlevGL reads that needed the card
+  uint32_t card_reads;   ///< Read transactions on the card
+  uint32_t card_bytes;   ///< Bytes read from the card
+  uint32_t direct_reads; ///< Card reads straight into LittlevGL's buffer
+} LvGLSdCacheStats;
+
+/**
+ * @brief SD font glyph cache statistics, see
+ * Adafruit_LvGL_Glue_SD::getFontStats()
+ */
+typedef struct {
+  uint32_t hits;   ///< Glyph lookups served from cache
+  uint32_t misses; ///< Glyph lookups that read the card
+  uint16_t slots;  ///< Glyphs the cache holds
+} LvGLFontStats;
+
+/**
+ * @brief Screen capture file formats, see
+ * Adafruit_LvGL_Glue_SD::captureScreen()
+ */
+typedef enum {
+  LVGL_CAPTURE_BMP, ///< 16-bit RGB565 .bmp file
+  LVGL_CAPTURE_RAW  ///< Bare RGB565 pixels, little-endian, top row first
+} LvGLCaptureFormat;
+
 /**
  * @brief Class to act as a "glue" layer between the LvGL graphics library and
  * most of Adafruit's TFT displays, with added support for reading from SD card.
@@ -20,13 +50,37 @@ public:
                    bool debug = false);
 
   LvGLStatus begin(Adafruit_SPITFT *tft, SdFat *sdFat, bool debug = false);
+  Adafruit_LvGL_Glue_SD(void);
+  void setReadCache(uint32_t bytes);
+  void getCacheStats(LvGLSdCacheStats *stats, bool reset = false);
+  bool captureScreen(const char *path,
+                     LvGLCaptureFormat format = LVGL_CAPTURE_BMP);
+  bool drawImage(const char *path, lv_coord_t x = 0, lv_coord_t y = 0);
+  void setFontCache(uint32_t bytes);
+  lv_font_t *loadFont(const char *path);
+  static void freeFont(lv_font_t *font);
+  static void getFontStats(const lv_font_t *font, LvGLFontStats *stats,
+                           bool reset = false);
 
   // The following need to be public for internal callbacks
-  SdFat *sd; ///< Pointer to SD card reader
+  SdFat *sd;                    ///< Pointer to SD card reader
+  uint32_t cache_size;          ///< Read cache per open file, bytes
+  LvGLSdCacheStats cache_stats; ///< Read cache statistics
+  void captureArea(const lv_area_t *area, const lv_color_t *pixels);
 
 private:
   void initFileSystem();
+  bool captureSeek(uint32_t offset);
+  bool captureWrite(const void *data, uint32_t bytes);
   lv_fs_drv_t lv_fs_drv;
+  lv_fs_file_t *capture_file; // Open during captureScreen()
+  uint32_t capture_pos;       // Write position in capture_file
+  uint32_t capture_size;      // Bytes written so far
+  uint32_t capture_header;    // Bytes before the first row
+  uint32_t capture_stride;    // Bytes per row, including padding
+  uint16_t *capture_row;      // Byte-swapping space (LV_COLOR_16_SWAP)
+  bool capture_ok;            // No write errors yet
+  uint32_t font_cache_size;   // As passed to setFontCache()
 };
 
 #endif //_ADAFRUIT_LVGL_GLUE_SD_H
@@ -0,0 +1,243 @@
+// Benchmark scenes for Adafruit_LvGL_Glue, see bench_scenes.h. Each scene
+// builds its objects on a clean screen, then changes something every frame
+// and has LittlevGL redraw right away with bench_refresh().
+
+#include "bench_scenes.h"
+
+typedef struct {
+  const char *name;
+  void (*setup)(lv_obj_t *scr, lv_coord_t w, lv_coord_t h);
+  void (*step)(uint32_t frame);
+} bench_scene_t;
+
+static lv_obj_t *bench_objs[64]; // Objects a scene changes each frame
+static uint16_t bench_obj_count;
+static lv_coord_t bench_span; // Scroll scene: scrollable distance
+
+// Small deterministic pseudo-random numbers, so every run is the same
+static uint32_t bench_seed;
+
+static uint32_t bench_rand(uint32_t range) {
+  bench_seed = bench_seed * 1103515245 + 12345;
+  return (bench_seed >> 16) % range;
+}
+
+// Full-screen scroll: a long list of rows scrolled a few pixels per frame,
+// so the whole screen changes every time
+
+static void scroll_setup(lv_obj_t *scr, lv_coord_t w, lv_coord_t h) {
+  lv_obj_t *list = lv_obj_create(scr);
+  lv_obj_set_size(list, w, h);
+  lv_obj_set_flex_flow(list, LV_FLEX_FLOW_COLUMN);
+  lv_obj_set_scrollbar_mode(list, LV_SCROLLBAR_MODE_OFF);
+  for (uint8_t i = 0; i < 30; i++) {
+    lv_obj_t *row = lv_label_create(list);
+    lv_label_set_text_fmt(row, "Row %d: the quick brown fox", (int)i);
+    lv_obj_set_style_bg_opa(row, (i & 1) ? LV_OPA_20 : LV_OPA_TRANSP, 0);
+    lv_obj_set_style_bg_color(row, lv_palette_main(LV_PALETTE_BLUE), 0);
+    lv_obj_set_width(row, lv_pct(100));
+  }
+  lv_obj_update_layout(list);
+  bench_span = lv_obj_get_scroll_bottom(list);
+  bench_objs[0] = list;
+  bench_obj_count = 1;
+}
+
+static void scroll_step(uint32_t frame) {
+  lv_coord_t y = (frame * 8) % (2 * bench_span + 1); // Down, then back up
+  if (y > bench_span) {
+    y = 2 * bench_span - y;
+  }
+  lv_obj_scroll_to_y(bench_objs[0], y, LV_ANIM_OFF);
+}
+
+// Many small label updates: a grid of counters, a few changing each frame,
+// for lots of small scattered areas
+
+static void labels_setup(lv_obj_t *scr, lv_coord_t w, lv_coord_t h) {
+  uint8_t cols = 4, rows = LV_MIN(h / 20, 64 / cols);
+  bench_obj_count = cols * rows;
+  for (uint16_t i = 0; i < bench_obj_count; i++) {
+    lv_obj_t *label = lv_label_create(scr);
+    lv_label_set_text(label, "0");
+    lv_obj_set_pos(label, (i % cols) * w / cols + 4, (i / cols) * h / rows);
+    bench_objs[i] = label;
+  }
+}
+
+static void labels_step(uint32_t) { // Random labels, whatever the frame
+  for (uint8_t i = 0; i < 8; i++) {
+    lv_obj_t *label = bench_objs[bench_rand(bench_obj_count)];
+    lv_label_set_text_fmt(label, "%d", (int)bench_rand(100000));
+  }
+}
+
+// Image-heavy grid: a screenful of small true-color images, all scrolling
+// their content each frame
+
+#define BENCH_IMG_SIZE 32
+static lv_color_t bench_pixels[BENCH_IMG_SIZE * BENCH_IMG_SIZE];
+static lv_img_dsc_t bench_img;
+
+static void images_setup(lv_obj_t *scr, lv_coord_t w, lv_coord_t h) {
+  for (uint16_t y = 0; y < BENCH_IMG_SIZE; y++) {
+    for (uint16_t x = 0; x < BENCH_IMG_SIZE; x++) {
+      bench_pixels[y * BENCH_IMG_SIZE + x] =
+          lv_color_make(x * 8, y * 8, (x ^ y) * 8);
+    }
+  }
+  bench_img.header.cf = LV_IMG_CF_TRUE_COLOR;
+  bench_img.header.w = BENCH_IMG_SIZE;
+  bench_img.header.h = BENCH_IMG_SIZE;
+  bench_img.data_size = sizeof(bench_pixels);
+  bench_img.data = (const uint8_t *)bench_pixels;
+
+  uint8_t cols = w / (BENCH_IMG_SIZE + 8), rows = h / (BENCH_IMG_SIZE + 8);
+  bench_obj_count = LV_MIN(cols * rows, 64);
+  for (uint16_t i = 0; i < bench_obj_count; i++) {
+    lv_obj_t *img = lv_img_create(scr);
+    lv_img_set_src(img, &bench_img);
+    lv_obj_set_pos(img, (i % cols) * (BENCH_IMG_SIZE + 8) + 4,
+                   (i / cols) * (BENCH_IMG_SIZE + 8) + 4);
+    bench_objs[i] = img;
+  }
+}
+
+static void images_step(uint32_t frame) {
+  for (uint16_t i = 0; i < bench_obj_count; i++) {
+    lv_img_set_offset_x(bench_objs[i], frame + i);
+    lv_img_set_offset_y(bench_objs[i], frame * 2);
+  }
+}
+
+// Arc and shadow animation: an arc gauge sweeping while a shadowed box
+// slides back and forth, for anti-aliasing and shadow rendering
+
+static void arc_setup(lv_obj_t *scr, lv_coord_t w, lv_coord_t h) {
+  lv_obj_t *arc = lv_arc_create(scr);
+  lv_coord_t size = LV_MIN(w, h) / 2;
+  lv_obj_set_size(arc, size, size);
+  lv_obj_align(arc, LV_ALIGN_CENTER, 0, -h / 8);
+  lv_obj_t *box = lv_obj_create(scr);
+  lv_obj_set_size(box, w / 4, h / 6);
+  lv_obj_set_style_radius(box, 10, 0);
+  lv_obj_set_style_shadow_width(box, 16, 0);
+  lv_obj_set_style_shadow_ofs_y(box, 4, 0);
+  lv_obj_align(box, LV_ALIGN_BOTTOM_LEFT, 0, -10);
+  bench_objs[0] = arc;
+  bench_objs[1] = box;
+  bench_obj_count = 2;
+  bench_span = w - w / 4 - 20;
+}
+
+static void arc_step(uint32_t frame) {
+  lv_coord_t x = (frame * 6) % (2 * bench_span + 1);
+  if (x > bench_span) {
+    x = 2 * bench_span - x;
+  }
+  lv_arc_set_value(bench_objs[0], (frame * 3) % 101);
+  lv_obj_set_x(bench_objs[1], x + 10);
+}
+
+// Chart streaming data: two line series with a new point each per frame
+
+static lv_chart_series_t *bench_series[2];
+
+static void chart_setup(lv_obj_t *scr, lv_coord_t w, lv_coord_t h) {
+  lv_obj_t *chart = lv_chart_create(scr);
+  lv_obj_set_size(chart, w - 20, h - 20);
+  lv_obj_center(chart);
+  lv_chart_set_point_count(chart, 50);
+  bench_series[0] = lv_chart_add_series(
+      chart, lv_palette_main(LV_PALETTE_RED), LV_CHART_AXIS_PRIMARY_Y);
+  bench_series[1] = lv_chart_add_series(
+      chart, lv_palette_main(LV_PALETTE_GREEN), LV_CHART_AXIS_PRIMARY_Y);
+  bench_objs[0] = chart;
+  bench_obj_count = 1;
+}
+
+static void chart_step(uint32_t frame) {
+  lv_coord_t saw = (frame * 4) % 100;
+  lv_chart_set_next_value(bench_objs[0], bench_series[0], saw);
+  lv_chart_set_next_value(bench_objs[0], bench_series[1], bench_rand(100));
+}
+
+static const bench_scene_t bench_scenes[] = {
+    {"scroll", scroll_setup, scroll_step},
+    {"labels", labels_setup, labels_step},
+    {"images", images_setup, images_step},
+    {"arc", arc_setup, arc_step},
+    {"chart", chart_setup, chart_step},
+};
+
+// Print value / divisor with one decimal, keeping to integers for boards
+// whose printf() has no floating point
+static void bench_print_ratio(uint64_t value, uint32_t divisor, int width) {
+  uint64_t tenths = (value * 10 + divisor / 2) / divisor;
+  Serial.printf(" %*lu.%lu", width - 2, (unsigned long)(tenths / 10),
+                (unsigned long)(tenths % 10));
+}
+
+// Redraw now, through lv_timer_handler() as a sketch would: the display's
+// refresh timer is made due at once rather than waiting out its period.
+// It then runs the glue's refresh callback, which merges dirty areas first
+// (lv_refr_now() would skip that).
+static void bench_refresh(lv_disp_t *disp) {
+  lv_timer_ready(disp->refr_timer);
+  lv_timer_handler();
+}
+
+void bench_run(Adafruit_LvGL_Glue &glue, uint16_t frames) {
+  if (!frames) {
+    return;
+  }
+  lv_disp_t *disp = glue.getDisplay();
+  lv_coord_t w = lv_disp_get_hor_res(disp), h = lv_disp_get_ver_res(disp);
+  Serial.printf("Display %dx%d, %d draw buffer(s) of %d rows, %d frames\r\n",
+                (int)w, (int)h, (int)glue.getBufferCount(),
+                (int)glue.getBufferRows(), (int)frames);
+  Serial.printf("scene        fps  flushes/f   bytes/f  flush us/f  "
+                "frame us avg\r\n");
+
+  for (uint8_t s = 0; s < sizeof(bench_scenes) / sizeof(bench_scenes[0]);
+       s++) {
+    const bench_scene_t *scene = &bench_scenes[s];
+#ifdef ESP32
+    glue.lvgl_acquire(); // Keep the GUI task out while we draw
+#endif
+    lv_obj_t *scr = lv_disp_get_scr_act(disp);
+    lv_obj_clean(scr);
+    bench_seed = 1;
+    scene->setup(scr, w, h);
+    bench_refresh(disp); // First frame isn't counted
+    glue.flushWait();
+
+    LvGLStats stats;
+    glue.getStats(&stats, true); // Reset
+    uint32_t start = micros();
+    for (uint32_t frame = 0; frame < frames; frame++) {
+      scene->step(frame);
+      bench_refresh(disp);
+    }
+    glue.flushWait(); // Last pixels out
+    uint32_t elapsed = micros() - start;
+    glue.getStats(&stats);
+#ifdef ESP32
+    glue.lvgl_release();
+#endif
+
+    Serial.printf("%-8s", scene->name);
+    bench_print_ratio((uint64_t)frames * 1000000, elapsed ? elapsed : 1, 7);
+    bench_print_ratio(stats.flushes, frames, 10);
+    bench_print_ratio(stats.bytes, frames, 9);
+    bench_print_ratio(stats.flush_us, frames, 11);
+    Serial.printf(" %13lu\r\n", (unsigned long)stats.frame_us_avg);
+  }
+#ifdef ESP32
+  glue.lvgl_acquire();
+#endif
+  lv_obj_clean(lv_disp_get_scr_act(disp));
+#ifdef ESP32
+  glue.lvgl_release();
+#endif
+}
@@ -0,0 +1,16 @@
+// Benchmark scenes for Adafruit_LvGL_Glue, shared by the benchmark sketch
+// and the host runner (extras/host/bench.cpp) so their numbers line up.
+
+#ifndef _BENCH_SCENES_H_
+#define _BENCH_SCENES_H_
+
+#include <Adafruit_LvGL_Glue.h> // Always include this BEFORE lvgl.h!
+#include <lvgl.h>
+
+// Run every scene for the given number of frames on glue's display and
+// print a line of results for each over Serial. Scenes are driven frame by
+// frame rather than by animations, so the same frames are drawn every run
+// regardless of how fast the display is.
+void bench_run(Adafruit_LvGL_Glue &glue, uint16_t frames);
+
+#endif // _BENCH_SCENES_H_
@@ -0,0 +1,67 @@
+// Rendering benchmark for Adafruit_LvGL_Glue on Adafruit TFT FeatherWings.
+// Runs a fixed set of scenes (full-screen scroll, label updates, an image
+// grid, arc and shadow animation, streaming chart) and prints frames/s,
+// flushes, bytes and flush time per frame to the Serial Monitor. Send any
+// character to run it again. The same scenes run on a Linux host with
+// extras/host/bench, so results can be compared between releases.
+// Requires LittlevGL, Adafruit_LvGL_Glue, Adafruit_GFX and Adafruit_ILI9341
+// (2.4" TFT) or Adafruit_HX8357 (3.5") libraries. If display is scrambled,
+// check that correct FeatherWing type is selected below.
+
+#define BIG_FEATHERWING 0 // Set this to 1 for 3.5" (480x320) FeatherWing!
+#define BENCH_FRAMES 100  // Frames per scene
+
+#include <Adafruit_LvGL_Glue.h> // Always include this BEFORE lvgl.h!
+#include <lvgl.h>
+#include "bench_scenes.h"
+
+#ifdef ESP32
+#define TFT_CS 15
+#define TFT_DC 33
+#else
+#define TFT_CS 9
+#define TFT_DC 10
+#endif
+#define TFT_ROTATION 1 // Landscape orientation on FeatherWing
+#define TFT_RST -1
+
+#if BIG_FEATHERWING
+#include <Adafruit_HX8357.h>
+Adafruit_HX8357 tft(TFT_CS, TFT_DC, TFT_RST);
+#else
+#include <Adafruit_ILI9341.h>
+Adafruit_ILI9341 tft(TFT_CS, TFT_DC);
+#endif
+
+Adafruit_LvGL_Glue glue;
+
+void setup(void) {
+  Serial.begin(115200);
+  while (!Serial)
+    delay(10); // Results go to the Serial Monitor, so wait for it
+
+  // Initialize display BEFORE glue setup
+  tft.begin();
+  tft.setRotation(TFT_ROTATION);
+
+  // Initialize glue, passing in address of display
+  LvGLStatus status = glue.begin(&tft);
+  if (status != LVGL_OK) {
+    Serial.printf("Glue error %d\r\n", (int)status);
+    for (;;)
+      ;
+  }
+
+  bench_run(glue, BENCH_FRAMES);
+}
+
+void loop(void) {
+  if (Serial.available()) {
+    while (Serial.available()) {
+      Serial.read();
+    }
+    bench_run(glue, BENCH_FRAMES);
+  }
+  lv_task_handler(); // Call LittleVGL task handler periodically
+  delay(5);
+}
@@ -0,0 +1,142 @@
+// Host stand-in for Adafruit_SPITFT. Instead of driving a panel, it records
+// address-window and pixel traffic into an in-memory framebuffer and keeps
+// counters so flush behavior can be measured off-target. Non-blocking
+// writePixels() calls emulate a DMA transfer whose duration follows the
+// configured bus clock, so render/transfer overlap shows up in timings.
+
+#ifndef _HOST_ADAFRUIT_SPITFT_H_
+#define _HOST_ADAFRUIT_SPITFT_H_
+
+#include "Arduino.h"
+
+// Exercise the same double-buffered code paths as SAMD51 DMA builds
+#define USE_SPI_DMA
+
+/**
+ * @brief Traffic counters kept by the host display stand-in
+ */
+typedef struct {
+  uint32_t start_writes;  ///< startWrite() calls
+  uint32_t end_writes;    ///< endWrite() calls
+  uint32_t addr_windows;  ///< setAddrWindow() calls
+  uint32_t pixel_writes;  ///< writePixels() calls
+  uint64_t pixels;        ///< Total pixels written
+  uint64_t bytes;         ///< Total bytes that would cross the bus
+  uint32_t dma_waits;     ///< dmaWait() calls that actually had to wait
+  uint64_t dma_wait_us;   ///< Time spent blocked in dmaWait()
+  uint32_t swapped_writes; ///< writePixels() calls with bigEndian == false
+} HostTFTCounters;
+
+/**
+ * @brief Framebuffer-backed replacement for the Adafruit_SPITFT display class
+ */
+class Adafruit_SPITFT {
+public:
+  /**
+   * @brief Create a host display of the given native (rotation 0) size
+   * @param w Native width in pixels
+   * @param h Native height in pixels
+   */
+  Adafruit_SPITFT(uint16_t w, uint16_t h)
+      : _native_w(w), _native_h(h), _rotation(0), _bus_hz(24000000),
+        _dma_done_us(0), _in_transaction(false) {
+    _fb = new uint16_t[(uint32_t)w * h]();
+    resetCounters();
+    _win_x = _win_y = _win_w = _win_h = 0;
+    _cur_x = _cur_y = 0;
+  }
+  ~Adafruit_SPITFT(void) { delete[] _fb; }
+
+  int16_t width(void) const { return (_rotation & 1) ? _native_h : _native_w; }
+  int16_t height(void) const {
+    return (_rotation & 1) ? _native_w : _native_h;
+  }
+  uint8_t getRotation(void) const { return _rotation; }
+  void setRotation(uint8_t r) { _rotation = r & 3; }
+
+  void startWrite(void) {
+    _in_transaction = true;
+    _counters.start_writes++;
+  }
+  void endWrite(void) {
+    _in_transaction = false;
+    _counters.end_writes++;
+  }
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    dmaWait(); // Real hardware can't issue commands mid-transfer either
+    _win_x = _cur_x = x;
+    _win_y = _cur_y = y;
+    _win_w = w;
+    _win_h = h;
+    _counters.addr_windows++;
+    _counters.bytes += 11; // CASET/RASET/RAMWR plus parameters
+  }
+
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true,
+                   bool bigEndian = false) {
+    dmaWait();
+    for (uint32_t i = 0; i < len; i++) {
+      uint16_t c = bigEndian ? __builtin_bswap16(colors[i]) : colors[i];
+      if ((_cur_x < width()) && (_cur_y < height())) {
+        _fb[(uint32_t)_cur_y * width() + _cur_x] = c;
+      }
+      if (++_cur_x >= _win_x + _win_w) {
+        _cur_x = _win_x;
+        _cur_y++;
+      }
+    }
+    _counters.pixel_writes++;
+    _counters.pixels += len;
+    _counters.bytes += len * 2;
+    _counters.swapped_writes += !bigEndian;
+    uint64_t xfer_us = ((uint64_t)len * 16 * 1000000) / _bus_hz;
+    if (block) {
+      delayMicroseconds((uint32_t)xfer_us);
+    } else {
+      _dma_done_us = micros() + xfer_us;
+    }
+  }
+
+  void dmaWait(void) {
+    if (dmaBusy()) {
+      uint32_t t0 = micros();
+      while (dmaBusy())
+        ;
+      _counters.dma_waits++;
+      _counters.dma_wait_us += micros() - t0;
+    }
+  }
+  bool dmaBusy(void) const { return (int32_t)(_dma_done_us - micros()) > 0; }
+
+  // Host-only helpers -------------------------------------------------
+
+  /**
+   * @brief Set the emulated bus clock used to time pixel transfers
+   * @param hz Bits per second
+   */
+  void setBusSpeed(uint32_t hz) { _bus_hz = hz ? hz : 1; }
+  /**
+   * @brief Read back a pixel from the emulated panel (native 565 order)
+   */
+  uint16_t getPixel(int16_t x, int16_t y) const {
+    return _fb[(uint32_t)y * width() + x];
+  }
+  const uint16_t *framebuffer(void) const { return _fb; }
+  bool inTransaction(void) const { return _in_transaction; }
+  const HostTFTCounters &counters(void) const { return _counters; }
+  void resetCounters(void) { memset(&_counters, 0, sizeof(_counters)); }
+
+private:
+  uint16_t *_fb;
+  uint16_t _native_w, _native_h;
+  uint8_t _rotation;
+  uint32_t _bus_hz;
+  uint32_t _dma_done_us;
+  bool _in_transaction;
+  uint16_t _win_x, _win_y, _win_w, _win_h;
+  uint16_t _cur_x, _cur_y;
+  HostTFTCounters _counters;
+};
+
+#endif // _HOST_ADAFRUIT_SPITFT_H_
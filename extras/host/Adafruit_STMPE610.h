@@ -0,0 +1,116 @@
+// Host stand-in for Adafruit_STMPE610. Touch samples are scripted with
+// push()/lift() and served back through the same bufferSize()/getPoint()
+// FIFO interface the glue polls on hardware. If setIrqPin() is used, the
+// start of each contact and each lift also fires that "pin interrupt".
+
+#ifndef _HOST_ADAFRUIT_STMPE610_H_
+#define _HOST_ADAFRUIT_STMPE610_H_
+
+#include "Arduino.h"
+#include <deque>
+
+#define STMPE_INT_CTRL 0x09
+#define STMPE_INT_CTRL_POL_HIGH 0x04
+#define STMPE_INT_CTRL_POL_LOW 0x00
+#define STMPE_INT_CTRL_EDGE 0x02
+#define STMPE_INT_CTRL_LEVEL 0x00
+#define STMPE_INT_CTRL_ENABLE 0x01
+#define STMPE_INT_CTRL_DISABLE 0x00
+#define STMPE_INT_EN 0x0A
+#define STMPE_INT_EN_TOUCHDET 0x01
+#define STMPE_INT_STA 0x0B
+
+/**
+ * @brief Raw STMPE610 touch sample
+ */
+class TS_Point {
+public:
+  TS_Point(void) : x(0), y(0), z(0) {}
+  TS_Point(int16_t x0, int16_t y0, int16_t z0) : x(x0), y(y0), z(z0) {}
+  int16_t x; ///< Raw X
+  int16_t y; ///< Raw Y
+  int16_t z; ///< Raw pressure
+};
+
+/**
+ * @brief Scripted replacement for the STMPE610 touch controller
+ */
+class Adafruit_STMPE610 {
+public:
+  Adafruit_STMPE610(uint8_t cs = 0) { (void)cs; }
+  bool begin(uint8_t addr = 0) {
+    (void)addr;
+    return true;
+  }
+
+  /**
+   * @brief Queue a raw sample as part of the current contact
+   */
+  void push(int16_t x, int16_t y, int16_t z = 32) {
+    bool starts_contact = _fifo.empty() || (_fifo.back().z < 0);
+    _fifo.push_back(TS_Point(x, y, z));
+    if (starts_contact) {
+      interrupt();
+    }
+  }
+  /**
+   * @brief Queue a release: the FIFO reads empty once before later samples
+   */
+  void lift(void) {
+    _fifo.push_back(TS_Point(-1, -1, -1));
+    interrupt();
+  }
+  /**
+   * @brief Host-only: pin whose "interrupt" fires on touch detect
+   */
+  void setIrqPin(int8_t pin) { _irq_pin = pin; }
+
+  bool touched(void) { return bufferSize() > 0; }
+  bool bufferEmpty(void) { return bufferSize() == 0; }
+  uint8_t bufferSize(void) {
+    _register_reads++;
+    uint8_t n = 0;
+    for (size_t i = 0; i < _fifo.size() && _fifo[i].z >= 0 && n < 128; i++) {
+      n++;
+    }
+    if (!n && !_fifo.empty()) {
+      _fifo.pop_front(); // Consume the release marker
+    }
+    return n;
+  }
+  TS_Point getPoint(void) {
+    _register_reads++;
+    TS_Point p;
+    if (!_fifo.empty() && _fifo.front().z >= 0) {
+      p = _fifo.front();
+      _fifo.pop_front();
+    }
+    return p;
+  }
+  uint8_t readRegister8(uint8_t reg) {
+    (void)reg;
+    _register_reads++;
+    return 0;
+  }
+  void writeRegister8(uint8_t reg, uint8_t val) {
+    (void)reg;
+    (void)val;
+  }
+
+  /**
+   * @brief Number of emulated SPI register accesses so far
+   */
+  uint32_t registerReads(void) const { return _register_reads; }
+
+private:
+  void interrupt(void) {
+    if (_irq_pin >= 0) {
+      host_trigger_interrupt(_irq_pin);
+    }
+  }
+  std::deque<TS_Point> _fifo;
+  uint32_t _register_reads = 0;
+  int8_t _irq_pin = -1;
+};
+
+#endif // _HOST_ADAFRUIT_STMPE610_H_
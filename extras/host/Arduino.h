@@ -0,0 +1,68 @@
+// Host stand-in for the bits of the Arduino core used by Adafruit_LvGL_Glue.
+// Only what the glue (and the host tools in this folder) actually call is
+// provided; this is NOT a general-purpose Arduino emulation layer. It must
+// stay C-compatible, since LittlevGL's tick code includes it through
+// LV_TICK_CUSTOM_INCLUDE.
+
+#ifndef _HOST_ARDUINO_H_
+#define _HOST_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ADAFRUIT_LVGL_GLUE_HOST
+#define ADAFRUIT_LVGL_GLUE_HOST
+#endif
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define RISING 0x3
+#define FALLING 0x2
+#define CHANGE 0x1
+#define digitalPinToInterrupt(p) (p)
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+static inline void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t interrupt);
+void host_trigger_interrupt(uint8_t interrupt);
+uint32_t millis(void);
+uint32_t micros(void);
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+#ifdef __cplusplus
+}
+#endif
+
+static inline void yield(void) {}
+
+static inline long map(long x, long in_min, long in_max, long out_min,
+                       long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+#ifdef __cplusplus
+/**
+ * @brief Minimal Serial replacement that writes to stdout
+ */
+class HostSerial {
+public:
+  void begin(unsigned long) {}
+  void print(const char *s) { fputs(s, stdout); }
+  void println(const char *s = "") { puts(s); }
+  int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  operator bool() const { return true; }
+};
+
+extern HostSerial Serial;
+#endif // __cplusplus
+
+#endif // _HOST_ARDUINO_H_
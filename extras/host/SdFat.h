@@ -0,0 +1,131 @@
+// Host stand-in for SdFat. Files live in an ordinary directory on the host
+// (the "card root", "." unless set with setRoot()). Counters record the
+// number of read calls and bytes so SD traffic can be measured off-target.
+
+#ifndef _HOST_SDFAT_H_
+#define _HOST_SDFAT_H_
+
+#include "Arduino.h"
+#include <fcntl.h>
+
+#ifndef O_READ
+#define O_READ O_RDONLY
+#endif
+#ifndef O_WRITE
+#define O_WRITE O_WRONLY
+#endif
+
+#define SD_SCK_MHZ(mhz) (mhz)
+
+/**
+ * @brief Traffic counters kept by the host SD stand-in
+ */
+typedef struct {
+  uint32_t opens;       ///< Successful open() calls
+  uint32_t reads;       ///< read() calls, i.e. emulated SD transactions
+  uint64_t read_bytes;  ///< Total bytes returned by read()
+  uint32_t writes;      ///< write() calls
+  uint64_t write_bytes; ///< Total bytes passed to write()
+  uint32_t seeks;       ///< seek() calls
+} HostSdCounters;
+
+extern HostSdCounters host_sd_counters;
+
+/**
+ * @brief Host file handle, copyable like SdFat's File
+ */
+class File {
+public:
+  File(void) : _fp(NULL) {}
+  explicit File(FILE *fp) : _fp(fp) {}
+  operator bool() const { return _fp != NULL; }
+
+  int read(void *buf, size_t n) {
+    if (!_fp) {
+      return -1;
+    }
+    host_sd_counters.reads++;
+    size_t got = fread(buf, 1, n, _fp);
+    host_sd_counters.read_bytes += got;
+    return ferror(_fp) ? -1 : (int)got;
+  }
+  size_t write(const void *buf, size_t n) {
+    if (!_fp) {
+      return 0;
+    }
+    host_sd_counters.writes++;
+    host_sd_counters.write_bytes += n;
+    return fwrite(buf, 1, n, _fp);
+  }
+  bool seek(uint32_t pos) {
+    host_sd_counters.seeks++;
+    return _fp && (fseek(_fp, pos, SEEK_SET) == 0);
+  }
+  bool seekCur(int32_t offset) {
+    host_sd_counters.seeks++;
+    return _fp && (fseek(_fp, offset, SEEK_CUR) == 0);
+  }
+  bool seekEnd(int32_t offset = 0) {
+    host_sd_counters.seeks++;
+    return _fp && (fseek(_fp, offset, SEEK_END) == 0);
+  }
+  uint32_t position(void) { return _fp ? (uint32_t)ftell(_fp) : 0; }
+  uint32_t size(void) {
+    if (!_fp) {
+      return 0;
+    }
+    long pos = ftell(_fp);
+    fseek(_fp, 0, SEEK_END);
+    long end = ftell(_fp);
+    fseek(_fp, pos, SEEK_SET);
+    return (uint32_t)end;
+  }
+  int available(void) { return (int)(size() - position()); }
+  bool sync(void) { return _fp && (fflush(_fp) == 0); }
+  bool close(void) {
+    bool ok = _fp && (fclose(_fp) == 0);
+    _fp = NULL;
+    return ok;
+  }
+
+private:
+  FILE *_fp;
+};
+
+/**
+ * @brief Host replacement for the SdFat volume class
+ */
+class SdFat {
+public:
+  SdFat(const char *root = ".") { setRoot(root); }
+  bool begin(uint8_t cs = 0, uint32_t speed = 0) {
+    (void)cs;
+    (void)speed;
+    return true;
+  }
+  void setRoot(const char *root) {
+    strncpy(_root, root, sizeof(_root) - 1);
+    _root[sizeof(_root) - 1] = 0;
+  }
+  File open(const char *path, int oflag = O_RDONLY) {
+    char full[512];
+    snprintf(full, sizeof(full), "%s/%s", _root, path);
+    const char *mode = "rb";
+    if (oflag & (O_WRONLY | O_RDWR)) {
+      mode = (oflag & O_TRUNC) ? "w+b" : "r+b";
+    }
+    FILE *fp = fopen(full, mode);
+    if (!fp && (oflag & O_CREAT)) {
+      fp = fopen(full, "w+b");
+    }
+    if (fp) {
+      host_sd_counters.opens++;
+    }
+    return File(fp);
+  }
+
+private:
+  char _root[256];
+};
+
+#endif // _HOST_SDFAT_H_
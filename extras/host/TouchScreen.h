@@ -0,0 +1,56 @@
+// Host stand-in for the Adafruit TouchScreen (resistive ADC) library.
+// Samples are scripted with push(); once the script runs dry every read
+// reports zero pressure, like an untouched panel.
+
+#ifndef _HOST_TOUCHSCREEN_H_
+#define _HOST_TOUCHSCREEN_H_
+
+#include "Arduino.h"
+#include <deque>
+
+/**
+ * @brief Raw resistive touch sample
+ */
+class TSPoint {
+public:
+  TSPoint(void) : x(0), y(0), z(0) {}
+  TSPoint(int16_t x0, int16_t y0, int16_t z0) : x(x0), y(y0), z(z0) {}
+  int16_t x; ///< Raw X ADC reading
+  int16_t y; ///< Raw Y ADC reading
+  int16_t z; ///< Raw pressure
+};
+
+/**
+ * @brief Scripted replacement for the resistive TouchScreen class
+ */
+class TouchScreen {
+public:
+  TouchScreen(uint8_t xp = 0, uint8_t yp = 0, uint8_t xm = 0, uint8_t ym = 0,
+              uint16_t rx = 0)
+      : pressureThreshhold(10) {
+    (void)xp, (void)yp, (void)xm, (void)ym, (void)rx;
+  }
+
+  /**
+   * @brief Queue one raw sample; z below pressureThreshhold reads as lifted
+   */
+  void push(int16_t x, int16_t y, int16_t z = 100) {
+    _samples.push_back(TSPoint(x, y, z));
+  }
+  TSPoint getPoint(void) {
+    TSPoint p;
+    if (!_samples.empty()) {
+      p = _samples.front();
+      _samples.pop_front();
+    }
+    return p;
+  }
+  size_t pending(void) const { return _samples.size(); }
+
+  int16_t pressureThreshhold; ///< Pressure threshold for a valid touch
+
+private:
+  std::deque<TSPoint> _samples;
+};
+
+#endif // _HOST_TOUCHSCREEN_H_
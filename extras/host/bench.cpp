@@ -0,0 +1,38 @@
+// Runs the benchmark sketch's scenes (examples/benchmark) through
+// Adafruit_LvGL_Glue on the host display stand-in, for catching render and
+// flush regressions without hardware. Optionally takes frames per scene, a
+// draw buffer height in rows ("full" for a whole screen, "direct" for direct
+// mode) and the emulated bus clock in MHz:
+//   ./bench [frames] [rows|full|direct] [MHz]
+
+#include "../../examples/benchmark/bench_scenes.h"
+
+int main(int argc, char *argv[]) {
+  uint16_t frames = (argc > 1) ? atoi(argv[1]) : 100;
+
+  Adafruit_SPITFT tft(240, 320); // ILI9341-sized panel...
+  tft.setRotation(1);            // ...in landscape, like the FeatherWing
+  Adafruit_LvGL_Glue glue;
+
+  if (argc > 2) {
+    if (!strcmp(argv[2], "full")) {
+      glue.setBufferSize(LVGL_BUFFER_FULL);
+    } else if (!strcmp(argv[2], "direct")) {
+      glue.setBufferSize(LVGL_BUFFER_DIRECT);
+    } else {
+      glue.setBufferSize(LVGL_BUFFER_ROWS, atoi(argv[2]));
+    }
+  }
+  if (argc > 3) {
+    tft.setBusSpeed(atoi(argv[3]) * 1000000);
+  }
+
+  LvGLStatus status = glue.begin(&tft);
+  if (status != LVGL_OK) {
+    Serial.printf("Glue error %d\n", (int)status);
+    return 1;
+  }
+
+  bench_run(glue, frames);
+  return 0;
+}
@@ -0,0 +1,55 @@
+// Clock, delay, Serial and SD counter definitions for the host Arduino stand-in.
+
+#include "Arduino.h"
+#include "SdFat.h"
+#include <stdarg.h>
+#include <time.h>
+
+HostSerial Serial;
+HostSdCounters host_sd_counters;
+
+static uint64_t now_us(void) {
+  static uint64_t start = 0;
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  uint64_t us = (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+  if (!start) {
+    start = us;
+  }
+  return us - start;
+}
+
+// Host "pin interrupts" are fired explicitly by the stand-ins
+static void (*host_isrs[64])(void);
+
+void attachInterrupt(uint8_t interrupt, void (*isr)(void), int mode) {
+  (void)mode;
+  host_isrs[interrupt & 63] = isr;
+}
+
+void detachInterrupt(uint8_t interrupt) { host_isrs[interrupt & 63] = NULL; }
+
+void host_trigger_interrupt(uint8_t interrupt) {
+  if (host_isrs[interrupt & 63]) {
+    host_isrs[interrupt & 63]();
+  }
+}
+
+uint32_t millis(void) { return (uint32_t)(now_us() / 1000); }
+
+uint32_t micros(void) { return (uint32_t)now_us(); }
+
+void delay(uint32_t ms) { delayMicroseconds(ms * 1000); }
+
+void delayMicroseconds(uint32_t us) {
+  struct timespec ts = {(time_t)(us / 1000000), (long)(us % 1000000) * 1000};
+  nanosleep(&ts, NULL);
+}
+
+int HostSerial::printf(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  int n = vprintf(fmt, args);
+  va_end(args);
+  return n;
+}
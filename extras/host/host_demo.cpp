@@ -0,0 +1,123 @@
+// Runs a small LittlevGL scene through Adafruit_LvGL_Glue on the host
+// display stand-in, with a scripted touch drag, and prints the resulting
+// bus traffic. Optionally dumps the final framebuffer as a PPM image and
+// takes a draw buffer height in rows ("full" for a whole screen, "direct"
+// for direct mode). Ends with a suspend(true)/resume() cycle. Exits
+// non-zero if nothing reached the display, or something did while it was
+// suspended. Final images should be identical whatever the buffer:
+//   ./host_demo [seconds] [out.ppm] [rows|full|direct]
+
+#include <Adafruit_LvGL_Glue.h> // Always include this BEFORE lvgl.h!
+#include <lvgl.h>
+
+static void write_ppm(const Adafruit_SPITFT &tft, const char *path) {
+  FILE *fp = fopen(path, "wb");
+  if (!fp) {
+    return;
+  }
+  fprintf(fp, "P6\n%d %d\n255\n", tft.width(), tft.height());
+  for (int16_t y = 0; y < tft.height(); y++) {
+    for (int16_t x = 0; x < tft.width(); x++) {
+      uint16_t c = tft.getPixel(x, y);
+      uint8_t rgb[3] = {(uint8_t)((c >> 8) & 0xF8), (uint8_t)((c >> 3) & 0xFC),
+                        (uint8_t)(c << 3)};
+      fwrite(rgb, 1, 3, fp);
+    }
+  }
+  fclose(fp);
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t seconds = (argc > 1) ? atoi(argv[1]) : 2;
+
+  Adafruit_SPITFT tft(240, 320); // ILI9341-sized panel...
+  tft.setRotation(1);            // ...in landscape, like the FeatherWing
+  Adafruit_STMPE610 ts;
+  Adafruit_LvGL_Glue glue;
+
+  // Script a horizontal drag across the middle of the slider
+  for (int16_t x = 3500; x > 600; x -= 100) {
+    ts.push(x, 1950);
+  }
+  ts.lift();
+
+  if (argc > 3) {
+    if (!strcmp(argv[3], "full")) {
+      glue.setBufferSize(LVGL_BUFFER_FULL);
+    } else if (!strcmp(argv[3], "direct")) {
+      glue.setBufferSize(LVGL_BUFFER_DIRECT);
+    } else {
+      glue.setBufferSize(LVGL_BUFFER_ROWS, atoi(argv[3]));
+    }
+  }
+
+  LvGLStatus status = glue.begin(&tft, &ts);
+  if (status != LVGL_OK) {
+    Serial.printf("Glue error %d\r\n", (int)status);
+    return 1;
+  }
+
+  lv_obj_t *label = lv_label_create(lv_scr_act());
+  lv_label_set_text(label, "Hello host!");
+  lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 20);
+  lv_obj_t *slider = lv_slider_create(lv_scr_act());
+  lv_obj_set_width(slider, 260);
+  lv_obj_center(slider);
+
+  // Tickless: service() sleeps until LittlevGL next has something to do
+  uint32_t start = millis(), passes = 0;
+  while ((millis() - start) < seconds * 1000) {
+    Adafruit_LvGL_Glue::service();
+    passes++;
+  }
+
+  // Sleep with the draw buffers freed, and force a refresh meanwhile: it
+  // mustn't reach the panel (or the freed buffers). resume() then redraws
+  // the whole screen, so the final image is the same.
+  glue.suspend(true);
+  uint64_t asleep = tft.counters().pixels;
+  lv_obj_invalidate(lv_scr_act());
+  lv_refr_now(glue.getDisplay());
+  bool slept = (tft.counters().pixels == asleep);
+  if (glue.resume() != LVGL_OK) {
+    slept = false;
+  }
+  start = millis();
+  while ((millis() - start) < 200) {
+    Adafruit_LvGL_Glue::service();
+  }
+  if (!slept) {
+    Serial.printf("Refresh reached the display while suspended\n");
+  }
+
+  const HostTFTCounters &c = tft.counters();
+  Serial.printf("Draw buffers    : %u x %u rows\n", glue.getBufferCount(),
+                glue.getBufferRows());
+  LvGLStats stats;
+  glue.getStats(&stats);
+  Serial.printf("Handler passes  : %u\n", passes);
+  Serial.printf("Frames          : %u\n", stats.frames);
+  Serial.printf("Flushes/frame   : %.2f\n",
+                stats.frames ? (double)stats.flushes / stats.frames : 0.0);
+  Serial.printf("Areas (raw/sent): %u / %u\n", stats.areas_raw,
+                stats.areas_merged);
+  Serial.printf("Frame us        : %u min, %u avg, %u max\n",
+                stats.frame_us_min, stats.frame_us_avg, stats.frame_us_max);
+  Serial.printf("Render/flush/DMA wait us: %u / %u / %u\n", stats.render_us,
+                stats.flush_us, stats.dma_wait_us);
+  Serial.printf("Bus yields/wait : %u / %u us\n", stats.bus_yields,
+                stats.bus_wait_us);
+  Serial.printf("Transactions    : %u\n", c.start_writes);
+  Serial.printf("Window commands : %u\n", c.addr_windows);
+  Serial.printf("Pixel writes    : %u\n", c.pixel_writes);
+  Serial.printf("Pixels          : %llu\n", (unsigned long long)c.pixels);
+  Serial.printf("Bus bytes       : %llu\n", (unsigned long long)c.bytes);
+  Serial.printf("DMA waits       : %u (%llu us)\n", c.dma_waits,
+                (unsigned long long)c.dma_wait_us);
+  Serial.printf("Touch reg reads : %u\n", ts.registerReads());
+
+  if (argc > 2) {
+    write_ppm(tft, argv[2]);
+  }
+  return (slept && stats.frames && c.pixels) ? 0 : 1;
+}
@@ -0,0 +1,541 @@
+// Checks the S: drive (Adafruit_LvGL_Glue_SD) against the files it reads,
+// going through LittlevGL's file and image decoder APIs. Test files are
+// written to, then read back from, the given directory:
+//   ./sd_test dir
+//   ../tools/img_convert.py dir/image16.bin dir/image16.rle (and image24)
+//   ../tools/img_convert.py --format native dir/image16.bin dir/image16.nat
+//   (and icon16)
+//   ./sd_test dir image16.rle image24.rle image16.nat icon16.nat
+// The first run checks random SET/CUR/END seeks and reads over a 100 KB
+// file, with every read cache size, loading a font and looking up its
+// glyphs with loadFont(), and captureScreen() to BMP and raw files, then
+// writes the test images. Given
+// .rle or .nat files, it decodes them line by line, in order and at
+// random, and compares the pixels with the .bin each was made from. Small
+// .nat images must come out of the decoder already in RAM.
+// Exits non-zero on any mismatch.
+
+#include <Adafruit_LvGL_Glue_SD.h> // Always include this BEFORE lvgl.h!
+#include <lvgl.h>
+
+#define SEEK_FILE_SIZE 100000
+#define IMAGE_W 200
+#define IMAGE_H 150
+#define ICON_W 40 // Small enough for a .nat to be read whole (8 KB)
+#define ICON_H 30
+#define IMAGE_CACHE 2048 // Read cache for the image checks
+#define IMAGE_BIN_MAX (4 + IMAGE_W * IMAGE_H * LV_IMG_PX_SIZE_ALPHA_BYTE)
+#define FONT_GLYPHS 185 // In the test font, not counting glyph 0
+#define FONT_BITMAP_MAX 112 // Bytes, 14x16 pixels at 4 bpp
+#define FONT_FILE_MAX 24576
+#define FONT_CACHE 1024 // Small enough that glyphs are evicted
+// Display for the capture checks: an odd width, so BMP rows are padded
+// (zero-filled by the capture), and a draw buffer height that doesn't
+// divide the screen, so it's captured in strips, the last one short
+#define SCREEN_W 239
+#define SCREEN_H 320
+#define SCREEN_ROWS 7
+#define CAPTURE_MAX (66 + (SCREEN_W + 1) * SCREEN_H * 2)
+
+// Small deterministic pseudo-random numbers, so every run is the same
+static uint32_t test_seed = 1;
+
+static uint32_t test_rand(uint32_t range) {
+  test_seed = test_seed * 1103515245 + 12345;
+  return ((test_seed >> 8) & 0xFFFFFF) % range;
+}
+
+static bool write_file(const char *dir, const char *name, const void *data,
+                       size_t len) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  FILE *fp = fopen(path, "wb");
+  if (!fp) {
+    perror(path);
+    return false;
+  }
+  bool ok = (fwrite(data, 1, len, fp) == len);
+  return (fclose(fp) == 0) && ok;
+}
+
+// Random seeks of every kind, each followed by a read of random length
+// (mostly short, some past the cache size so they go straight to the
+// card), compared against the reference bytes
+static bool check_seeks(Adafruit_LvGL_Glue_SD &glue, const uint8_t *ref) {
+  static const uint32_t caches[] = {0, 512, 2048, 4096};
+  static uint8_t buf[20000];
+
+  for (uint8_t c = 0; c < sizeof(caches) / sizeof(caches[0]); c++) {
+    glue.setReadCache(caches[c]); // Applies to files opened after this
+    LvGLSdCacheStats stats;
+    glue.getCacheStats(&stats, true); // Reset
+    for (uint16_t trial = 0; trial < 50; trial++) {
+      lv_fs_file_t file;
+      if (lv_fs_open(&file, "S:/seek.bin", LV_FS_MODE_RD) != LV_FS_RES_OK) {
+        printf("Can't open seek.bin\n");
+        return false;
+      }
+      uint32_t pos = 0;
+      for (uint16_t i = 0; i < 50; i++) {
+        lv_fs_res_t res = LV_FS_RES_OK;
+        int32_t delta;
+        switch (test_rand(4)) {
+        case 0: // Anywhere, including past the end
+          pos = test_rand(SEEK_FILE_SIZE + 500);
+          res = lv_fs_seek(&file, pos, LV_FS_SEEK_SET);
+          break;
+        case 1: // Back or forward from here, not before the start
+          delta = (int32_t)test_rand(4000) - 2000;
+          if ((int32_t)pos + delta < 0) {
+            delta = -(int32_t)pos;
+          }
+          pos += delta;
+          res = lv_fs_seek(&file, (uint32_t)delta, LV_FS_SEEK_CUR);
+          break;
+        case 2: // Back from the end
+          delta = -(int32_t)test_rand(5000);
+          pos = SEEK_FILE_SIZE + delta;
+          res = lv_fs_seek(&file, (uint32_t)delta, LV_FS_SEEK_END);
+          break;
+        default: // Read on from where the last one ended
+          break;
+        }
+        uint32_t n = test_rand(3) ? test_rand(300) : test_rand(sizeof(buf));
+        uint32_t want = (pos < SEEK_FILE_SIZE)
+                            ? LV_MIN(n, (uint32_t)SEEK_FILE_SIZE - pos)
+                            : 0;
+        uint32_t got = 0, tell = 0;
+        bool ok = (res == LV_FS_RES_OK) &&
+                  (lv_fs_read(&file, buf, n, &got) == LV_FS_RES_OK) &&
+                  (got == want) && (!got || !memcmp(buf, &ref[pos], got));
+        pos += got;
+        if (!ok || (lv_fs_tell(&file, &tell) != LV_FS_RES_OK) ||
+            (tell != pos)) {
+          printf("Mismatch: cache %u, offset %u, %u bytes\n",
+                 (unsigned)caches[c], (unsigned)pos, (unsigned)n);
+          lv_fs_close(&file);
+          return false;
+        }
+      }
+      lv_fs_close(&file);
+    }
+    glue.getCacheStats(&stats);
+    printf("Seeks, cache %4u: %u card reads (%u direct), %u KB\n",
+           (unsigned)caches[c], (unsigned)stats.card_reads,
+           (unsigned)stats.direct_reads, (unsigned)(stats.card_bytes / 1024));
+  }
+  return true;
+}
+
+// Test image in LittlevGL's .bin layout (4-byte header, then rows of
+// pixels): flat-color blocks, which encode as runs, crossed by a band of
+// noise, which encodes as literals. Returns its size in bytes.
+static uint32_t make_image(uint8_t *bin, uint8_t cf, uint16_t w, uint16_t h) {
+  lv_img_header_t header;
+  memset(&header, 0, sizeof(header));
+  header.cf = cf;
+  header.w = w;
+  header.h = h;
+  memcpy(bin, &header, sizeof(header));
+  uint8_t *p = &bin[sizeof(header)];
+  for (uint16_t y = 0; y < h; y++) {
+    for (uint16_t x = 0; x < w; x++) {
+      uint16_t c = (x / 40) * 0x1863 + (y / 30) * 0x4208;
+      uint8_t a = (x / 25) * 32;
+      if ((y >= h / 2) && (y < h / 2 + 10)) {
+        c = test_rand(0x10000);
+        a = test_rand(256);
+      }
+      *p++ = c & 0xFF;
+      *p++ = c >> 8;
+      if (cf == LV_IMG_CF_TRUE_COLOR_ALPHA) {
+        *p++ = a;
+      }
+    }
+  }
+  return p - bin;
+}
+
+// One glyph of the test font, as LittlevGL should get it back
+typedef struct {
+  uint32_t letter;
+  uint16_t adv_w;
+  int8_t ofs_x, ofs_y;
+  uint8_t box_w, box_h;
+  uint8_t bitmap[FONT_BITMAP_MAX]; // 4 bpp, MSB first, rows run on
+} ref_glyph_t;
+
+static ref_glyph_t font_ref[FONT_GLYPHS]; // By glyph id - 1
+
+static uint8_t *put_le(uint8_t *p, uint32_t value, uint8_t bytes) {
+  while (bytes--) {
+    *p++ = value & 0xFF;
+    value >>= 8;
+  }
+  return p;
+}
+
+// Append n bits of value, MSB first, to a zeroed buffer
+static void put_bits(uint8_t *buf, uint32_t *bit, uint32_t value, uint8_t n) {
+  while (n--) {
+    if ((value >> n) & 1) {
+      buf[*bit / 8] |= 0x80 >> (*bit % 8);
+    }
+    (*bit)++;
+  }
+}
+
+// Test font in LittlevGL's binary format (lv_font_conv --format bin
+// --no-compress): 4 bpp random glyphs, 16-bit glyph offsets and one cmap
+// subtable of each kind. The two "full" kinds map letters to glyphs in
+// reverse, so their lookup tables matter. Fills in font_ref, returns the
+// file's size in bytes.
+static uint32_t make_font(uint8_t *out) {
+  // cmap subtables: first letter, letters, spacing and format (0 format0
+  // full, 1 sparse full, 2 format0 tiny, 3 sparse tiny)
+  static const uint32_t starts[] = {0x20, 0x3000, 0x4E00, 0x5000};
+  static const uint8_t counts[] = {95, 10, 60, 20}, steps[] = {1, 1, 7, 5},
+                       formats[] = {2, 0, 3, 1};
+  // head: tables_count, font_size, ascent, descent, typo_ascent,
+  // typo_descent, typo_line_gap, min_y, max_y, default_advance_width,
+  // kerning_scale; then index_to_loc_format, glyph_id_format,
+  // advance_width_format, bits_per_pixel, xy_bits, wh_bits,
+  // advance_width_bits, compression_id, subpixels_mode, padding
+  static const int16_t head16[] = {4, 16, 15, -4, 15, -4, 0, -4, 15, 0, 0};
+  static const uint8_t head8[] = {0, 0, 1, 4, 5, 5, 9, 0, 0, 0};
+  memset(out, 0, FONT_FILE_MAX);
+  uint8_t *p = put_le(out, 48, 4);
+  memcpy(p, "head", 4);
+  p = put_le(p + 4, 1, 4); // version
+  for (uint8_t i = 0; i < sizeof(head16) / sizeof(head16[0]); i++) {
+    p = put_le(p, (uint16_t)head16[i], 2);
+  }
+  memcpy(p, head8, sizeof(head8));
+  p = put_le(p + sizeof(head8), (uint16_t)-2, 2); // underline_position
+  p = put_le(p, 1, 2);                            // underline_thickness
+
+  uint8_t *cmap = p, *sub = p + 12;
+  put_le(cmap + 8, 4, 4); // Subtable count
+  p = sub + 4 * 16;
+  uint16_t id = 1;
+  for (uint8_t c = 0; c < 4; c++) {
+    uint8_t n = counts[c];
+    bool reversed = (formats[c] < 2);
+    sub = put_le(sub, p - cmap, 4);
+    sub = put_le(sub, starts[c], 4);
+    sub = put_le(sub, (n - 1) * steps[c] + 1, 2);
+    sub = put_le(sub, id, 2);
+    sub = put_le(sub, (formats[c] == 2) ? 0 : n, 2);
+    sub = put_le(sub, formats[c], 2); // And padding
+    for (uint8_t i = 0; i < n; i++) {
+      font_ref[id - 1 + (reversed ? n - 1 - i : i)].letter =
+          starts[c] + i * steps[c];
+      if (formats[c] == 0) {
+        *p++ = n - 1 - i;
+      }
+    }
+    for (uint8_t i = 0; (formats[c] & 1) && (i < n); i++) {
+      p = put_le(p, i * steps[c], 2); // Code points (from starts[c])
+    }
+    for (uint8_t i = 0; (formats[c] == 1) && (i < n); i++) {
+      p = put_le(p, n - 1 - i, 2); // Then their glyphs (from id)
+    }
+    while ((p - cmap) % 4) {
+      p++;
+    }
+    id += n;
+  }
+  put_le(cmap, p - cmap, 4);
+  memcpy(cmap + 4, "cmap", 4);
+
+  uint8_t *loca = p;
+  p = put_le(loca, 12 + (FONT_GLYPHS + 1) * 2, 4);
+  memcpy(p, "loca", 4);
+  p = put_le(p + 4, FONT_GLYPHS + 1, 4);
+  uint8_t *glyf = p + (FONT_GLYPHS + 1) * 2;
+  uint32_t bit = 8 * 8; // Records follow the glyf section header
+  p = put_le(p, 8, 2); // Glyph 0, empty
+  for (uint16_t g = 0; g < FONT_GLYPHS; g++) {
+    p = put_le(p, bit / 8, 2);
+    ref_glyph_t *ref = &font_ref[g];
+    uint16_t adv = test_rand(301); // 1/16 px
+    ref->adv_w = (adv + 8) >> 4;
+    ref->ofs_x = test_rand(16) - 8;
+    ref->ofs_y = test_rand(16) - 8;
+    ref->box_w = test_rand(15);
+    ref->box_h = test_rand(17);
+    put_bits(glyf, &bit, adv, 9);
+    put_bits(glyf, &bit, ref->ofs_x & 0x1F, 5);
+    put_bits(glyf, &bit, ref->ofs_y & 0x1F, 5);
+    put_bits(glyf, &bit, ref->box_w, 5);
+    put_bits(glyf, &bit, ref->box_h, 5);
+    memset(ref->bitmap, 0, sizeof(ref->bitmap));
+    uint32_t ref_bit = 0;
+    for (uint16_t i = 0; i < ref->box_w * ref->box_h; i++) {
+      uint8_t px = test_rand(16);
+      put_bits(glyf, &bit, px, 4);
+      put_bits(ref->bitmap, &ref_bit, px, 4);
+    }
+    bit = (bit + 7) & ~7; // Records start on a byte
+  }
+  put_le(glyf, bit / 8, 4);
+  memcpy(glyf + 4, "glyf", 4);
+  return (glyf - out) + bit / 8;
+}
+
+// Load the test font with a small glyph cache, then look up glyphs in
+// random order, as LittlevGL does to draw them (metrics, then bitmap), and
+// letters that aren't in it
+static bool check_font(Adafruit_LvGL_Glue_SD &glue) {
+  static const uint32_t missing[] = {0x1F, 0x7F, 0x300A, 0x4E01, 0x5001};
+  glue.setFontCache(FONT_CACHE);
+  lv_font_t *font = glue.loadFont("S:/font.bin");
+  if (!font) {
+    printf("font.bin: can't load\n");
+    return false;
+  }
+  bool ok = (font->line_height == 19) && (font->base_line == 4);
+  lv_font_glyph_dsc_t dsc;
+  for (uint16_t i = 0; ok && (i < 5000); i++) {
+    const ref_glyph_t *ref = &font_ref[test_rand(FONT_GLYPHS)];
+    memset(&dsc, 0, sizeof(dsc));
+    ok = lv_font_get_glyph_dsc(font, &dsc, ref->letter, 0) &&
+         (dsc.adv_w == ref->adv_w) && (dsc.ofs_x == ref->ofs_x) &&
+         (dsc.ofs_y == ref->ofs_y) && (dsc.box_w == ref->box_w) &&
+         (dsc.box_h == ref->box_h) && (dsc.bpp == 4);
+    const uint8_t *bitmap = lv_font_get_glyph_bitmap(font, ref->letter);
+    ok = ok && bitmap &&
+         !memcmp(bitmap, ref->bitmap, (ref->box_w * ref->box_h + 1) / 2);
+    if (!ok) {
+      printf("font.bin: glyph U+%04X doesn't match\n",
+             (unsigned)ref->letter);
+    }
+  }
+  for (uint8_t i = 0; ok && (i < sizeof(missing) / sizeof(missing[0])); i++) {
+    ok = !lv_font_get_glyph_dsc(font, &dsc, missing[i], 0);
+    if (!ok) {
+      printf("font.bin: found U+%04X, not in font\n", (unsigned)missing[i]);
+    }
+  }
+  LvGLFontStats stats;
+  Adafruit_LvGL_Glue_SD::getFontStats(font, &stats);
+  printf("Font: %u glyph slots, %u hits, %u misses\n", (unsigned)stats.slots,
+         (unsigned)stats.hits, (unsigned)stats.misses);
+  if (ok && ((stats.slots < 2) || (stats.slots >= FONT_GLYPHS) ||
+             !stats.hits || (stats.hits + stats.misses !=
+              5000 + sizeof(missing) / sizeof(missing[0])))) {
+    printf("font.bin: glyph cache not used as expected\n");
+    ok = false;
+  }
+  Adafruit_LvGL_Glue_SD::freeFont(font);
+  return ok;
+}
+
+// Capture the screen in one format, and compare the file byte for byte
+// with what the display stand-in shows: the file built from its
+// framebuffer, in the same layout
+static bool check_capture(Adafruit_LvGL_Glue_SD &glue,
+                          const Adafruit_SPITFT &tft, const char *dir,
+                          LvGLCaptureFormat format) {
+  static uint8_t got[CAPTURE_MAX + 1], want[CAPTURE_MAX];
+  const char *name = (format == LVGL_CAPTURE_BMP) ? "screen.bmp" : "screen.raw";
+  char path[512];
+  snprintf(path, sizeof(path), "S:/%s", name);
+  if (!glue.captureScreen(path, format)) {
+    printf("%s: capture failed\n", name);
+    return false;
+  }
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  FILE *fp = fopen(path, "rb");
+  if (!fp) {
+    perror(path);
+    return false;
+  }
+  uint32_t got_size = fread(got, 1, sizeof(got), fp);
+  fclose(fp);
+
+  uint32_t w = tft.width(), h = tft.height(), stride = w * 2, header = 0;
+  memset(want, 0, sizeof(want));
+  if (format == LVGL_CAPTURE_BMP) {
+    header = 66;
+    stride = (stride + 3) & ~3;
+    // BITMAPINFOHEADER with RGB565 masks, top row first
+    uint8_t *p = want;
+    *p++ = 'B';
+    *p++ = 'M';
+    p = put_le(p, header + stride * h, 4);
+    p = put_le(p, 0, 4);
+    p = put_le(p, header, 4);
+    p = put_le(p, 40, 4);
+    p = put_le(p, w, 4);
+    p = put_le(p, -(int32_t)h, 4);
+    p = put_le(p, 1, 2);
+    p = put_le(p, 16, 2);
+    p = put_le(p, 3, 4);
+    p = put_le(p, stride * h, 4);
+    p = put_le(p, 2835, 4);
+    p = put_le(p, 2835, 4);
+    p = put_le(p, 0, 8);
+    p = put_le(p, 0xF800, 4);
+    p = put_le(p, 0x07E0, 4);
+    put_le(p, 0x001F, 4);
+  }
+  for (uint32_t y = 0; y < h; y++) {
+    uint8_t *p = &want[header + y * stride];
+    for (uint32_t x = 0; x < w; x++) {
+      p = put_le(p, tft.getPixel(x, y), 2);
+    }
+  }
+  uint32_t want_size = header + stride * h, diff = 0;
+  while ((diff < want_size) && (got[diff] == want[diff])) {
+    diff++;
+  }
+  printf("%s: %u bytes\n", name, (unsigned)got_size);
+  if (got_size != want_size) {
+    printf("%s: should be %u bytes\n", name, (unsigned)want_size);
+    return false;
+  }
+  if (diff < want_size) {
+    printf("%s: differs from the display at byte %u\n", name,
+           (unsigned)diff);
+    return false;
+  }
+  return true;
+}
+
+static uint32_t file_size(const char *dir, const char *name) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  FILE *fp = fopen(path, "rb");
+  if (!fp) {
+    return 0;
+  }
+  fseek(fp, 0, SEEK_END);
+  uint32_t size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+// Decode one .rle or .nat image through LittlevGL and compare it with the
+// .bin of the same name
+static bool check_image(Adafruit_LvGL_Glue_SD &glue, const char *dir,
+                        const char *name) {
+  static uint8_t ref[IMAGE_BIN_MAX], buf[IMAGE_W * LV_IMG_PX_SIZE_ALPHA_BYTE];
+  char path[512];
+  int base = strrchr(name, '.') ? (int)(strrchr(name, '.') - name) : 0;
+  snprintf(path, sizeof(path), "%s/%.*s.bin", dir, base, name);
+  FILE *fp = fopen(path, "rb");
+  if (!fp) {
+    perror(path);
+    return false;
+  }
+  uint32_t ref_size = fread(ref, 1, sizeof(ref), fp);
+  fclose(fp);
+
+  lv_img_decoder_dsc_t dsc;
+  LvGLSdCacheStats stats;
+  glue.setReadCache(IMAGE_CACHE);
+  glue.getCacheStats(&stats, true); // Reset
+  snprintf(path, sizeof(path), "S:/%s", name);
+  if (lv_img_decoder_open(&dsc, path, lv_color_black(), 0) != LV_RES_OK) {
+    printf("%s: can't decode\n", path);
+    return false;
+  }
+  lv_coord_t w = dsc.header.w, h = dsc.header.h;
+  uint8_t px = (dsc.header.cf == LV_IMG_CF_TRUE_COLOR_ALPHA)
+                   ? LV_IMG_PX_SIZE_ALPHA_BYTE
+                   : sizeof(lv_color_t);
+  bool ok = (ref_size == 4 + (uint32_t)w * h * px);
+  bool in_ram = (dsc.img_data != NULL);
+
+  // Top to bottom, each row in two pieces as a clipped draw would ask,
+  // then random pieces of random rows. Card traffic is counted from the
+  // open to the end of the first pass.
+  for (lv_coord_t y = 0; ok && (y < h); y++) {
+    for (uint8_t part = 0; ok && (part < 2); part++) {
+      lv_coord_t x = part ? w / 3 : 0, len = part ? w - w / 3 : w / 3;
+      ok = (lv_img_decoder_read_line(&dsc, x, y, len, buf) == LV_RES_OK) &&
+           !memcmp(buf, &ref[4 + ((uint32_t)y * w + x) * px], len * px);
+    }
+  }
+  glue.getCacheStats(&stats);
+  for (uint16_t i = 0; ok && (i < 20000); i++) {
+    lv_coord_t y = test_rand(h), x = test_rand(w), len = 1 + test_rand(w - x);
+    ok = (lv_img_decoder_read_line(&dsc, x, y, len, buf) == LV_RES_OK) &&
+         !memcmp(buf, &ref[4 + ((uint32_t)y * w + x) * px], len * px);
+  }
+  lv_img_decoder_close(&dsc);
+
+  // In order, the card should be read about once through: the file's
+  // size, plus at most a cache's worth of read-ahead
+  uint32_t size = file_size(dir, name);
+  printf("%s: %dx%d, .bin %u bytes, file %u bytes, %u read in order%s\n",
+         name, (int)w, (int)h, (unsigned)ref_size, (unsigned)size,
+         (unsigned)stats.card_bytes, in_ram ? ", in RAM" : "");
+  if (!ok) {
+    printf("%s: pixels don't match the .bin\n", name);
+  } else if (stats.card_bytes > size + IMAGE_CACHE) {
+    printf("%s: read more than its size from the card\n", name);
+    ok = false;
+  } else if (!strcmp(&name[base], ".nat") && ((uint32_t)w * h * 2 <= 8192) &&
+             !in_ram) {
+    printf("%s: small .nat not read into RAM\n", name);
+    ok = false;
+  }
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s dir\n", argv[0]);
+    return 1;
+  }
+  const char *dir = argv[1];
+
+  static uint8_t seek_ref[SEEK_FILE_SIZE];
+  for (uint32_t i = 0; i < SEEK_FILE_SIZE; i++) {
+    seek_ref[i] = test_rand(256);
+  }
+  static uint8_t image[IMAGE_BIN_MAX], font[FONT_FILE_MAX];
+  uint32_t font_size = make_font(font);
+  if ((argc == 2) &&
+      (!write_file(dir, "seek.bin", seek_ref, sizeof(seek_ref)) ||
+       !write_file(dir, "font.bin", font, font_size) ||
+       !write_file(dir, "image16.bin", image,
+                   make_image(image, LV_IMG_CF_TRUE_COLOR, IMAGE_W, IMAGE_H)) ||
+       !write_file(dir, "image24.bin", image,
+                   make_image(image, LV_IMG_CF_TRUE_COLOR_ALPHA, IMAGE_W,
+                              IMAGE_H)) ||
+       !write_file(dir, "icon16.bin", image,
+                   make_image(image, LV_IMG_CF_TRUE_COLOR, ICON_W, ICON_H)))) {
+    return 1;
+  }
+
+  Adafruit_SPITFT tft(SCREEN_W, SCREEN_H);
+  SdFat sd(dir);
+  Adafruit_LvGL_Glue_SD glue;
+  glue.setBufferSize(LVGL_BUFFER_ROWS, SCREEN_ROWS);
+  LvGLStatus status = glue.begin(&tft, &sd);
+  if (status != LVGL_OK) {
+    printf("Glue error %d\n", (int)status);
+    return 1;
+  }
+
+  bool ok = true;
+  if (argc == 2) {
+    // Something to capture
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "Capture");
+    lv_obj_align(label, LV_ALIGN_TOP_MID, 0, 20);
+    lv_obj_t *slider = lv_slider_create(lv_scr_act());
+    lv_obj_center(slider);
+    ok = check_seeks(glue, seek_ref) && check_font(glue) &&
+         check_capture(glue, tft, dir, LVGL_CAPTURE_BMP) &&
+         check_capture(glue, tft, dir, LVGL_CAPTURE_RAW);
+  }
+  for (int i = 2; ok && (i < argc); i++) {
+    ok = check_image(glue, dir, argv[i]);
+  }
+  printf(ok ? "SD checks passed\n" : "SD checks FAILED\n");
+  return ok ? 0 : 1;
+}
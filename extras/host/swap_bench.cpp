@@ -0,0 +1,58 @@
+// Compares Adafruit_LvGL_Glue::swapBytes() against a plain per-pixel swap
+// loop (the way Adafruit_SPITFT swaps as it sends) on typical draw buffer
+// sizes, and checks that both give the same result.
+//   ./swap_bench [iterations]
+
+#include <Adafruit_LvGL_Glue.h>
+
+// Per-pixel reference. Vectorization is disabled so the host measures the
+// shape of loop an MCU actually runs, not what a desktop compiler makes of
+// it.
+__attribute__((optimize("no-tree-vectorize"))) static void
+swap_per_pixel(uint16_t *pixels, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    pixels[i] = __builtin_bswap16(pixels[i]);
+  }
+}
+
+typedef void (*swap_fn)(uint16_t *, uint32_t);
+
+static double bench(swap_fn fn, uint16_t *buf, uint32_t count,
+                    uint32_t iterations) {
+  uint32_t t0 = micros();
+  for (uint32_t i = 0; i < iterations; i++) {
+    fn(buf, count);
+  }
+  return (double)(micros() - t0) * 1000.0 / ((double)iterations * count);
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t iterations = (argc > 1) ? atoi(argv[1]) : 2000;
+  static const uint32_t sizes[] = {320 * 4, 320 * 8, 480 * 20, 320 * 240};
+  static const char *names[] = {"320x4", "320x8", "480x20", "320x240"};
+  bool ok = true;
+
+  Serial.printf("%-8s %14s %14s %8s\n", "buffer", "per-pixel ns", "glue ns",
+                "speedup");
+  for (uint8_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    uint32_t count = sizes[s];
+    // +1 so the unaligned start case is exercised too
+    uint16_t *a = new uint16_t[count + 1];
+    uint16_t *b = new uint16_t[count + 1];
+    for (uint32_t i = 0; i <= count; i++) {
+      a[i] = b[i] = (uint16_t)(i * 2654435761u);
+    }
+    swap_per_pixel(a + 1, count);
+    Adafruit_LvGL_Glue::swapBytes(b + 1, count);
+    ok &= !memcmp(a, b, (count + 1) * sizeof(uint16_t));
+
+    double ref = bench(swap_per_pixel, a, count, iterations);
+    double glue = bench(Adafruit_LvGL_Glue::swapBytes, b, count, iterations);
+    Serial.printf("%-8s %14.3f %14.3f %7.2fx\n", names[s], ref, glue,
+                  ref / glue);
+    delete[] a;
+    delete[] b;
+  }
+  Serial.println(ok ? "Results match" : "MISMATCH between kernels!");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,91 @@
+// Replays a recorded touch trace through Adafruit_LvGL_TouchFilter and
+// reports how many position changes LittlevGL would have seen with and
+// without it (each one is a potential drag event and redraw). Exits
+// non-zero if the filter made the trace move more, not less.
+//   ./touch_replay trace.txt [median] [smooth] [dead_zone] [-v]
+// Trace format, one sample per line, in screen coordinates: "x y" while
+// pressed, "-" on release. Lines starting with '#' are ignored. A trace
+// can be captured from a sketch by printing touch_x/touch_y in readTouch(),
+// after apply_calibration() and before touch_filter.process().
+
+#include <Adafruit_LvGL_Glue.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct TraceStats {
+  uint32_t moves;    // Reported position changed while pressed
+  uint32_t distance; // Sum of |dx| + |dy| over those changes
+  bool pressed;
+  lv_coord_t x, y;
+};
+
+static void track(TraceStats *s, lv_coord_t x, lv_coord_t y) {
+  if (s->pressed && ((x != s->x) || (y != s->y))) {
+    s->moves++;
+    s->distance += abs(x - s->x) + abs(y - s->y);
+  }
+  s->pressed = true;
+  s->x = x;
+  s->y = y;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s trace.txt [median] [smooth] [dead_zone] [-v]\n",
+            argv[0]);
+    return 1;
+  }
+  FILE *in = strcmp(argv[1], "-") ? fopen(argv[1], "r") : stdin;
+  if (!in) {
+    perror(argv[1]);
+    return 1;
+  }
+  LvGLTouchFilter config = {3, 2, 2};
+  if (argc > 2)
+    config.median = atoi(argv[2]);
+  if (argc > 3)
+    config.smooth = atoi(argv[3]);
+  if (argc > 4)
+    config.dead_zone = atoi(argv[4]);
+  bool verbose = (argc > 5) && !strcmp(argv[5], "-v");
+
+  Adafruit_LvGL_TouchFilter filter;
+  filter.configure(&config);
+  TraceStats raw = {0, 0, false, 0, 0}, filtered = raw;
+  uint32_t samples = 0, presses = 0;
+  char line[80];
+
+  while (fgets(line, sizeof line, in)) {
+    int x, y;
+    if (line[0] == '#') {
+      continue;
+    } else if (line[0] == '-') {
+      filter.reset();
+      raw.pressed = filtered.pressed = false;
+      if (verbose)
+        printf("-\n");
+    } else if (sscanf(line, "%d %d", &x, &y) == 2) {
+      lv_coord_t fx = x, fy = y;
+      presses += !raw.pressed;
+      samples++;
+      filter.process(&fx, &fy);
+      track(&raw, x, y);
+      track(&filtered, fx, fy);
+      if (verbose)
+        printf("%d %d -> %d %d\n", x, y, fx, fy);
+    }
+  }
+  if (in != stdin)
+    fclose(in);
+
+  printf("Filter: median %u, smooth %u, dead zone %u\n", config.median,
+         config.smooth, config.dead_zone);
+  printf("%u samples, %u presses\n", samples, presses);
+  printf("Raw:      %u moves, %u px travelled\n", raw.moves, raw.distance);
+  printf("Filtered: %u moves, %u px travelled\n", filtered.moves,
+         filtered.distance);
+  return ((filtered.moves > raw.moves) || (filtered.distance > raw.distance))
+             ? 1
+             : 0;
+}
@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""
+Convert images for Adafruit_LvGL_Glue_SD's image decoders.
+
+Input is a LittlevGL .bin image in a true color format (as made by
+LittlevGL's online converter, with 16-bit color), or with Pillow installed,
+any image Pillow can read (PNG, JPEG, ...). Output is:
+
+  rle     Run-length encoded (.rle). Much smaller than .bin for flat-color
+          art like icons and UI backgrounds, so less to read from SD. Any
+          image LittlevGL can draw from a .bin can be drawn from this.
+  native  Display-native (.nat): opaque RGB565 in the display's own
+          (big-endian) byte order, for Adafruit_LvGL_Glue_SD::drawImage()
+          to send straight to the display. Best for full-screen splash
+          images. LittlevGL can draw these as well.
+
+Usage:
+  img_convert.py [--format rle|native] [--swap] input output
+
+--swap is for lv_conf.h with LV_COLOR_16_SWAP set: .bin input is taken to
+be byte-swapped already, and .rle output is byte-swapped to match.
+"""
+
+import argparse
+import struct
+import sys
+
+CF_TRUE_COLOR = 4
+CF_TRUE_COLOR_ALPHA = 5
+CF_TRUE_COLOR_CHROMA_KEYED = 6
+
+RLE_MAGIC = b"LVRL"
+NAT_MAGIC = b"LVNT"
+
+
+def pixel_size(cf):
+    """Bytes per pixel of a true color format (16-bit color)."""
+    if cf in (CF_TRUE_COLOR, CF_TRUE_COLOR_CHROMA_KEYED):
+        return 2
+    if cf == CF_TRUE_COLOR_ALPHA:
+        return 3
+    raise ValueError("unsupported color format %d (true color only)" % cf)
+
+
+def pack_header(cf, width, height):
+    """LittlevGL's 4-byte image header."""
+    return struct.pack("<I", cf | (width << 10) | (height << 21))
+
+
+def load_bin(path):
+    """Read a LittlevGL .bin; returns (cf, width, height, rows)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    (header,) = struct.unpack("<I", data[:4])
+    cf, width, height = header & 0x1F, (header >> 10) & 0x7FF, header >> 21
+    stride = width * pixel_size(cf)
+    if len(data) < 4 + stride * height:
+        raise ValueError("%s: truncated image data" % path)
+    rows = [data[4 + y * stride : 4 + (y + 1) * stride] for y in range(height)]
+    return cf, width, height, rows
+
+
+def load_image(path, swap):
+    """Read any image via Pillow; returns (cf, width, height, rows)."""
+    try:
+        from PIL import Image
+    except ImportError:
+        sys.exit("Pillow is needed to read %s (or convert it to .bin)" % path)
+    img = Image.open(path)
+    alpha = img.mode in ("RGBA", "LA", "PA") or "transparency" in img.info
+    img = img.convert("RGBA")
+    width, height = img.size
+    pixels = img.load()
+    cf = CF_TRUE_COLOR_ALPHA if alpha else CF_TRUE_COLOR
+    rows = []
+    for y in range(height):
+        row = bytearray()
+        for x in range(width):
+            r, g, b, a = pixels[x, y]
+            c = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+            row += struct.pack(">H" if swap else "<H", c)
+            if alpha:
+                row.append(a)
+        rows.append(bytes(row))
+    return cf, width, height, rows
+
+
+def rle_row(row, size):
+    """Encode one row as literal and run packets."""
+    pixels = [row[i : i + size] for i in range(0, len(row), size)]
+    out = bytearray()
+    literal = []
+
+    def flush_literal():
+        while literal:
+            chunk = literal[:128]
+            del literal[:128]
+            out.append(len(chunk) - 1)
+            out.extend(b"".join(chunk))
+
+    i = 0
+    while i < len(pixels):
+        run = 1
+        while (
+            i + run < len(pixels) and run < 128 and pixels[i + run] == pixels[i]
+        ):
+            run += 1
+        if run >= 2:  # A run of 2 is already no bigger than literals
+            flush_literal()
+            out.append(127 + run)
+            out.extend(pixels[i])
+        else:
+            literal.append(pixels[i])
+        i += run
+    flush_literal()
+    return bytes(out)
+
+
+def write_rle(path, cf, width, height, rows):
+    size = pixel_size(cf)
+    encoded = [rle_row(row, size) for row in rows]
+    offset = len(RLE_MAGIC) + 4 + 4 * height
+    table = bytearray()
+    for row in encoded:
+        table += struct.pack("<I", offset)
+        offset += len(row)
+    with open(path, "wb") as f:
+        f.write(RLE_MAGIC)
+        f.write(pack_header(cf, width, height))
+        f.write(table)
+        for row in encoded:
+            f.write(row)
+    return offset
+
+
+def write_native(path, cf, width, height, rows, swapped):
+    if cf != CF_TRUE_COLOR:
+        raise ValueError("native images must be opaque (LV_IMG_CF_TRUE_COLOR)")
+    with open(path, "wb") as f:
+        f.write(NAT_MAGIC)
+        f.write(pack_header(cf, width, height))
+        for row in rows:
+            if not swapped:  # To big-endian
+                row = bytes(
+                    b for i in range(0, len(row), 2) for b in (row[i + 1], row[i])
+                )
+            f.write(row)
+    return len(NAT_MAGIC) + 4 + 2 * width * height
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Convert images for Adafruit_LvGL_Glue_SD"
+    )
+    parser.add_argument("--format", choices=["rle", "native"], default="rle")
+    parser.add_argument(
+        "--swap", action="store_true", help="byte-swap 16-bit pixels"
+    )
+    parser.add_argument("input")
+    parser.add_argument("output")
+    args = parser.parse_args()
+
+    if args.input.lower().endswith(".bin"):
+        cf, width, height, rows = load_bin(args.input)
+    else:
+        if args.format == "native":
+            args.swap = False  # Loaded little-endian, swapped on output
+        cf, width, height, rows = load_image(args.input, args.swap)
+    before = 4 + sum(len(row) for row in rows)
+    if args.format == "native":
+        after = write_native(args.output, cf, width, height, rows, args.swap)
+    else:
+        after = write_rle(args.output, cf, width, height, rows)
+    print(
+        "%s: %dx%d, %d -> %d bytes (%.1fx)"
+        % (args.output, width, height, before, after, before / after)
+    )
+
+
+if __name__ == "__main__":
+    main()
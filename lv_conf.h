@@ -24,7 +24,17 @@
 
 /* Swap the 2 bytes of RGB565 color.
  * Useful if the display has a 8 bit interface (e.g. SPI)*/
-#if defined(ADAFRUIT_PYPORTAL)
+/*Set per board in Adafruit_LvGL_Glue_Board.h. Where that isn't on the
+ *include path (this file copied next to lvgl), the same default is used
+ *here; set LVGL_BOARD_COLOR_SWAP with a build flag to change it for both*/
+#if defined(__has_include)
+#if __has_include("Adafruit_LvGL_Glue_Board.h")
+#include "Adafruit_LvGL_Glue_Board.h"
+#endif
+#endif
+#if defined(LVGL_BOARD_COLOR_SWAP)
+#define LV_COLOR_16_SWAP LVGL_BOARD_COLOR_SWAP
+#elif defined(ADAFRUIT_PYPORTAL)
 #define LV_COLOR_16_SWAP 1
 #else
 #define LV_COLOR_16_SWAP 0
@@ -88,7 +98,11 @@
 
 /*Use a custom tick source that tells the elapsed time in milliseconds.
  *It removes the need to manually update the tick with `lv_tick_inc()`)*/
-#define LV_TICK_CUSTOM 0
+#if defined(ADAFRUIT_LVGL_GLUE_HOST)
+#define LV_TICK_CUSTOM 1 /*Host builds (extras/host) have no tick timer*/
+#else
+#define LV_TICK_CUSTOM 0 /*1 runs Adafruit_LvGL_Glue "tickless", see README*/
+#endif
 #if LV_TICK_CUSTOM
 #define LV_TICK_CUSTOM_INCLUDE                                                 \
   "Arduino.h" /*Header for the system time function*/